@@ -0,0 +1,194 @@
+// bench/json_writer_bench.cpp
+//
+// Times the JSON responses against the ostringstream code they replaced, on
+// a synthetic library of 400k videos in 2000 courses and one course of 20k
+// videos. Build with -DUTEC_BUILD_BENCHMARKS=ON in a Release tree and run
+// json_writer_bench; the optional argument is the number of repetitions.
+#include "api/json_response.h"
+#include "utils/flat_library.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+using namespace utec;
+
+namespace {
+
+// The previous implementation: a character at a time into a fresh string,
+// and every piece streamed through an ostringstream
+std::string baselineEscape(std::string_view str) {
+    std::string result;
+    for (char c : str) {
+        switch (c) {
+            case '"':  result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\b': result += "\\b"; break;
+            case '\f': result += "\\f"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:   result += c; break;
+        }
+    }
+    return result;
+}
+
+std::string baselineLibrary(const FlatLibrary& library) {
+    std::ostringstream json;
+    json << "{\n  \"status\": \"success\",\n  \"data\": {\n    \"years\": [\n";
+
+    for (FlatLibrary::Index y = 0; y < library.yearCount(); ++y) {
+        json << "      {\n";
+        json << "        \"year\": \"" << baselineEscape(library.yearName(y)) << "\",\n";
+        json << "        \"semesters\": [\n";
+
+        for (FlatLibrary::Index s = library.semesterBegin(y); s < library.semesterEnd(y); ++s) {
+            json << "          {\n";
+            json << "            \"name\": \"" << baselineEscape(library.semesterName(s)) << "\",\n";
+            json << "            \"courses\": [\n";
+
+            for (FlatLibrary::Index c = library.courseBegin(s); c < library.courseEnd(s); ++c) {
+                json << "              {\n";
+                json << "                \"name\": \"" << baselineEscape(library.courseName(c)) << "\",\n";
+                if (library.courseScanned(c)) {
+                    json << "                \"video_count\": " << library.courseVideoCount(c) << "\n";
+                } else {
+                    json << "                \"video_count\": null\n";
+                }
+                json << "              }";
+                if (c + 1 < library.courseEnd(s)) json << ",";
+                json << "\n";
+            }
+
+            json << "            ]\n";
+            json << "          }";
+            if (s + 1 < library.semesterEnd(y)) json << ",";
+            json << "\n";
+        }
+
+        json << "        ]\n";
+        json << "      }";
+        if (y + 1 < library.yearCount()) json << ",";
+        json << "\n";
+    }
+
+    json << "    ]\n  }\n}";
+    return json.str();
+}
+
+std::string baselineCourse(const FlatLibrary& library, FlatLibrary::Index course) {
+    std::ostringstream json;
+    json << "{\n  \"status\": \"success\",\n  \"data\": {\n";
+    json << "    \"name\": \"" << baselineEscape(library.courseName(course)) << "\",\n";
+    json << "    \"videos\": [\n";
+
+    for (FlatLibrary::Index v = library.videoBegin(course); v < library.videoEnd(course); ++v) {
+        json << "      {\n";
+        json << "        \"name\": \"" << baselineEscape(library.videoName(v)) << "\",\n";
+        json << "        \"path\": \"" << baselineEscape(library.videoRelativePath(v)) << "\",\n";
+        json << "        \"size\": " << library.videoSize(v) << ",\n";
+        json << "        \"extension\": \"" << baselineEscape(library.videoExtension(v)) << "\"\n";
+        json << "      }";
+        if (v + 1 < library.videoEnd(course)) json << ",";
+        json << "\n";
+    }
+
+    json << "    ]\n  }\n}";
+    return json.str();
+}
+
+// Milliseconds per call; the output sizes are summed so no call is optimized out
+template <typename Build>
+double millisecondsPerCall(int repetitions, Build build) {
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; ++i) {
+        bytes += build().size();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    if (bytes == 0) {
+        std::puts("empty output");
+    }
+    return std::chrono::duration<double, std::milli>(elapsed).count() / repetitions;
+}
+
+void report(const char* name, double baseline_ms, double writer_ms) {
+    std::printf("%-26s %9.3f ms -> %8.3f ms  (%.1fx)\n", name, baseline_ms, writer_ms, baseline_ms / writer_ms);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int repetitions = argc > 1 ? std::atoi(argv[1]) : 20;
+    if (repetitions <= 0) {
+        repetitions = 20;
+    }
+
+    // 5 years of 2 semesters, 200 courses each with 200 videos
+    char name[128];
+    FlatLibrary library("/srv/videos");
+    for (int y = 0; y < 5; ++y) {
+        library.addYear(std::to_string(2020 + y));
+        for (int s = 1; s <= 2; ++s) {
+            library.addSemester("Semester_" + std::to_string(s));
+            for (int c = 0; c < 200; ++c) {
+                std::snprintf(name, sizeof(name), "Course_%03d_Computer_Science", c);
+                library.addCourse(name, 1);
+                for (int v = 0; v < 200; ++v) {
+                    std::snprintf(name, sizeof(name), "Lecture %03d - Introduction to \"Topic\" part %d.mp4", v, v % 7);
+                    library.addVideo(name, 123456789ULL + v);
+                }
+            }
+        }
+    }
+    library.finish();
+
+    FlatLibrary big("/srv/videos");
+    big.addYear("2024");
+    big.addSemester("Semester_1");
+    big.addCourse("Big_Course", 1);
+    for (int v = 0; v < 20000; ++v) {
+        std::snprintf(name, sizeof(name), "Week_%02d_Session_%05d_Recording.mp4", v % 16, v);
+        big.addVideo(name, 987654321ULL + v);
+    }
+    big.finish();
+
+    // The same names with and without quotes: most real names have nothing
+    // to escape, so the clean run is the common case
+    std::string quoted_names;
+    std::string clean_names;
+    for (FlatLibrary::Index v = 0; v < library.videoCount(); ++v) {
+        quoted_names.append(library.videoName(v));
+        std::snprintf(name, sizeof(name), "Lecture %03d - Introduction to Topic part %d.mp4", v % 200, v % 7);
+        clean_names.append(name);
+    }
+
+    // Without control characters the two produce the same bytes
+    if (JsonResponse::createLibraryResponse(library) != baselineLibrary(library) ||
+        JsonResponse::createCourseResponse(big, 0) != baselineCourse(big, 0) ||
+        JsonResponse::escapeJson(quoted_names) != baselineEscape(quoted_names)) {
+        std::puts("output differs from the baseline");
+        return 1;
+    }
+
+    std::printf("%zu videos in %zu courses, %d repetitions\n", library.videoCount(), library.courseCount(),
+                repetitions);
+    report("library listing",
+           millisecondsPerCall(repetitions, [&]() { return baselineLibrary(library); }),
+           millisecondsPerCall(repetitions, [&]() { return JsonResponse::createLibraryResponse(library); }));
+    report("course with 20k videos",
+           millisecondsPerCall(repetitions, [&]() { return baselineCourse(big, 0); }),
+           millisecondsPerCall(repetitions, [&]() { return JsonResponse::createCourseResponse(big, 0); }));
+    std::snprintf(name, sizeof(name), "escaping %zu MB, clean", clean_names.size() >> 20);
+    report(name,
+           millisecondsPerCall(repetitions, [&]() { return baselineEscape(clean_names); }),
+           millisecondsPerCall(repetitions, [&]() { return JsonResponse::escapeJson(clean_names); }));
+    std::snprintf(name, sizeof(name), "escaping %zu MB, quoted", quoted_names.size() >> 20);
+    report(name,
+           millisecondsPerCall(repetitions, [&]() { return baselineEscape(quoted_names); }),
+           millisecondsPerCall(repetitions, [&]() { return JsonResponse::escapeJson(quoted_names); }));
+    return 0;
+}
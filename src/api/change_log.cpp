@@ -0,0 +1,146 @@
+// src/api/change_log.cpp
+#include "api/change_log.h"
+#include <string_view>
+#include <unordered_map>
+
+namespace utec {
+
+namespace {
+
+using Index = FlatLibrary::Index;
+
+} // namespace
+
+ChangeLog::ChangeLog(size_t capacity) : capacity_(capacity) {
+}
+
+void ChangeLog::reset(uint64_t generation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    changes_.clear();
+    oldest_generation_ = generation;
+    newest_generation_ = generation;
+}
+
+void ChangeLog::record(uint64_t generation, const FlatLibrary& before, const FlatLibrary& after) {
+    std::vector<Change> changes;
+    auto add = [&](Action action, Kind kind, std::string path, uint64_t size) {
+        changes.push_back(Change{generation, action, kind, std::move(path), size});
+    };
+    auto addVideos = [&](Action action, const FlatLibrary& library, Index course) {
+        for (Index v = library.videoBegin(course); v < library.videoEnd(course); ++v) {
+            add(action, Kind::VIDEO, library.videoRelativePath(v), library.videoSize(v));
+        }
+    };
+
+    std::unordered_map<std::string, Index> previous;
+    previous.reserve(before.courseCount());
+    for (Index c = 0; c < before.courseCount(); ++c) {
+        previous.emplace(before.courseRelativePath(c), c);
+    }
+
+    std::vector<bool> kept(before.courseCount(), false);
+    for (Index c = 0; c < after.courseCount(); ++c) {
+        std::string path = after.courseRelativePath(c);
+        auto it = previous.find(path);
+        if (it == previous.end()) {
+            add(Action::ADDED, Kind::COURSE, std::move(path), 0);
+            addVideos(Action::ADDED, after, c);
+            continue;
+        }
+
+        Index old = it->second;
+        kept[old] = true;
+        if (FlatLibrary::sameCourse(before, old, after, c)) {
+            continue;
+        }
+        add(Action::CHANGED, Kind::COURSE, std::move(path), 0);
+
+        // Listings are short; match the videos by name
+        std::unordered_map<std::string_view, Index> old_videos;
+        for (Index v = before.videoBegin(old); v < before.videoEnd(old); ++v) {
+            old_videos.emplace(before.videoName(v), v);
+        }
+        for (Index v = after.videoBegin(c); v < after.videoEnd(c); ++v) {
+            auto found = old_videos.find(after.videoName(v));
+            if (found == old_videos.end()) {
+                add(Action::ADDED, Kind::VIDEO, after.videoRelativePath(v), after.videoSize(v));
+                continue;
+            }
+            if (before.videoSize(found->second) != after.videoSize(v)) {
+                add(Action::CHANGED, Kind::VIDEO, after.videoRelativePath(v), after.videoSize(v));
+            }
+            old_videos.erase(found);
+        }
+        for (Index v = before.videoBegin(old); v < before.videoEnd(old); ++v) {
+            if (old_videos.count(before.videoName(v))) {
+                add(Action::REMOVED, Kind::VIDEO, before.videoRelativePath(v), before.videoSize(v));
+            }
+        }
+    }
+
+    for (Index c = 0; c < before.courseCount(); ++c) {
+        if (!kept[c]) {
+            add(Action::REMOVED, Kind::COURSE, before.courseRelativePath(c), 0);
+            addVideos(Action::REMOVED, before, c);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& change : changes) {
+        changes_.push_back(std::move(change));
+    }
+    newest_generation_ = generation;
+    recorded_ += changes.size();
+
+    // Whole generations are dropped, so whatever is left is complete
+    while (changes_.size() > capacity_) {
+        uint64_t dropped = changes_.front().generation;
+        while (!changes_.empty() && changes_.front().generation == dropped) {
+            changes_.pop_front();
+        }
+        oldest_generation_ = dropped;
+        ++truncated_;
+    }
+}
+
+bool ChangeLog::changesSince(uint64_t since, uint64_t until, std::vector<Change>& changes) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (since < oldest_generation_ || since > until || until > newest_generation_) {
+        return false;
+    }
+
+    for (const auto& change : changes_) {
+        if (change.generation > until) {
+            break;
+        }
+        if (change.generation > since) {
+            changes.push_back(change);
+        }
+    }
+    return true;
+}
+
+ChangeLog::Stats ChangeLog::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.entries = changes_.size();
+    stats.oldest_generation = oldest_generation_;
+    stats.recorded = recorded_;
+    stats.truncated = truncated_;
+    return stats;
+}
+
+const char* ChangeLog::actionName(Action action) {
+    switch (action) {
+        case Action::ADDED:   return "added";
+        case Action::REMOVED: return "removed";
+        case Action::CHANGED: return "changed";
+    }
+    return "";
+}
+
+const char* ChangeLog::kindName(Kind kind) {
+    return kind == Kind::COURSE ? "course" : "video";
+}
+
+} // namespace utec
@@ -0,0 +1,63 @@
+// src/api/change_log.h
+#pragma once
+#include "utils/flat_library.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace utec {
+
+    // What changed between consecutive library generations, so clients can
+    // catch up without downloading the whole tree. Only the most recent
+    // changes are kept; a client that fell further behind has to resync.
+    class ChangeLog {
+    public:
+        enum class Action { ADDED, REMOVED, CHANGED };
+        enum class Kind { COURSE, VIDEO };
+
+        struct Change {
+            uint64_t generation;  // the first generation that has the change
+            Action action;
+            Kind kind;
+            std::string path;     // relative to the library root
+            uint64_t size;        // videos only
+        };
+
+        struct Stats {
+            uint64_t entries = 0;
+            uint64_t oldest_generation = 0;  // changes since this one are all kept
+            uint64_t recorded = 0;
+            uint64_t truncated = 0;          // generations dropped for space
+        };
+
+        explicit ChangeLog(size_t capacity);
+
+        // Drops the history; changes are known from generation on
+        void reset(uint64_t generation);
+
+        // Records how after differs from before as the changes of generation
+        void record(uint64_t generation, const FlatLibrary& before, const FlatLibrary& after);
+
+        // Changes after since, up to and including until; false when they are
+        // no longer kept, or since is not a generation this log has seen
+        bool changesSince(uint64_t since, uint64_t until, std::vector<Change>& changes) const;
+
+        Stats stats() const;
+
+        static const char* actionName(Action action);
+        static const char* kindName(Kind kind);
+
+    private:
+        size_t capacity_;
+        mutable std::mutex mutex_;
+        std::deque<Change> changes_;
+        uint64_t oldest_generation_ = 0;
+        uint64_t newest_generation_ = 0;
+        uint64_t recorded_ = 0;
+        uint64_t truncated_ = 0;
+    };
+
+} // namespace utec
@@ -1,127 +1,199 @@
 // src/api/json_response.cpp
 #include "api/json_response.h"
-#include "utils/string_utils.h"
-#include <sstream>
+#include "api/json_writer.h"
 
 namespace utec {
 
-std::string JsonResponse::createLibraryResponse(const VideoLibrary& library) {
-    std::ostringstream json;
-    json << "{\n  \"status\": \"success\",\n  \"data\": {\n    \"years\": [\n";
-
-    for (size_t i = 0; i < library.size(); ++i) {
-        const auto& year = library[i];
-        json << "      {\n";
-        json << "        \"year\": \"" << escapeJson(year.year) << "\",\n";
-        json << "        \"semesters\": [\n";
-
-        for (size_t j = 0; j < year.semesters.size(); ++j) {
-            const auto& semester = year.semesters[j];
-            json << "          {\n";
-            json << "            \"name\": \"" << escapeJson(semester.name) << "\",\n";
-            json << "            \"courses\": [\n";
-
-            for (size_t k = 0; k < semester.courses.size(); ++k) {
-                const auto& course = semester.courses[k];
-                json << "              {\n";
-                json << "              {\n";
-                json << "                \"name\": \"" << escapeJson(course.name) << "\",\n";
-                json << "                \"video_count\": " << course.videos.size() << "\n";
-                json << "              }";
-                if (k < semester.courses.size() - 1) json << ",";
-                json << "\n";
+std::string JsonResponse::createLibraryResponse(const FlatLibrary& library) {
+    // Roughly the indentation and keys of each entry plus its name
+    JsonWriter json(library.arenaSize() + library.courseCount() * 96 + library.semesterCount() * 96 +
+                    library.yearCount() * 64 + 128);
+    json.raw("{\n  \"status\": \"success\",\n  \"data\": {\n    \"years\": [\n");
+
+    for (FlatLibrary::Index y = 0; y < library.yearCount(); ++y) {
+        json.raw("      {\n");
+        json.raw("        \"year\": ").string(library.yearName(y)).raw(",\n");
+        json.raw("        \"semesters\": [\n");
+
+        for (FlatLibrary::Index s = library.semesterBegin(y); s < library.semesterEnd(y); ++s) {
+            json.raw("          {\n");
+            json.raw("            \"name\": ").string(library.semesterName(s)).raw(",\n");
+            json.raw("            \"courses\": [\n");
+
+            for (FlatLibrary::Index c = library.courseBegin(s); c < library.courseEnd(s); ++c) {
+                json.raw("              {\n");
+                json.raw("                \"name\": ").string(library.courseName(c)).raw(",\n");
+                if (library.courseScanned(c)) {
+                    json.raw("                \"video_count\": ").number(library.courseVideoCount(c)).raw("\n");
+                } else {
+                    // Not listed yet by a lazy scan
+                    json.raw("                \"video_count\": null\n");
+                }
+                json.raw("              }");
+                if (c + 1 < library.courseEnd(s)) json.raw(",");
+                json.raw("\n");
             }
 
-            json << "            ]\n";
-            json << "          }";
-            if (j < year.semesters.size() - 1) json << ",";
-            json << "\n";
+            json.raw("            ]\n");
+            json.raw("          }");
+            if (s + 1 < library.semesterEnd(y)) json.raw(",");
+            json.raw("\n");
         }
 
-        json << "        ]\n";
-        json << "      }";
-        if (i < library.size() - 1) json << ",";
-        json << "\n";
+        json.raw("        ]\n");
+        json.raw("      }");
+        if (y + 1 < library.yearCount()) json.raw(",");
+        json.raw("\n");
     }
 
-    json << "    ]\n  }\n}";
-    return json.str();
+    json.raw("    ]\n  }\n}");
+    return json.take();
 }
 
-std::string JsonResponse::createCourseResponse(const Course& course) {
-    std::ostringstream json;
-    json << "{\n  \"status\": \"success\",\n  \"data\": {\n";
-    json << "    \"name\": \"" << escapeJson(course.name) << "\",\n";
-    json << "    \"videos\": [\n";
-
-    for (size_t i = 0; i < course.videos.size(); ++i) {
-        const auto& video = course.videos[i];
-        json << "      {\n";
-        json << "        \"name\": \"" << escapeJson(video.name) << "\",\n";
-        json << "        \"path\": \"" << escapeJson(video.relative_path) << "\",\n";
-        json << "        \"size\": " << video.size << ",\n";
-        json << "        \"extension\": \"" << escapeJson(video.extension) << "\"\n";
-        json << "      }";
-        if (i < course.videos.size() - 1) json << ",";
-        json << "\n";
+std::string JsonResponse::createCourseResponse(const FlatLibrary& library, FlatLibrary::Index course) {
+    JsonWriter json(library.courseVideoCount(course) * 256 + 128);
+    json.raw("{\n  \"status\": \"success\",\n  \"data\": {\n");
+    json.raw("    \"name\": ").string(library.courseName(course)).raw(",\n");
+    json.raw("    \"videos\": [\n");
+
+    for (FlatLibrary::Index v = library.videoBegin(course); v < library.videoEnd(course); ++v) {
+        json.raw("      {\n");
+        json.raw("        \"name\": ").string(library.videoName(v)).raw(",\n");
+        json.raw("        \"path\": ").string(library.videoRelativePath(v)).raw(",\n");
+        json.raw("        \"size\": ").number(library.videoSize(v)).raw(",\n");
+        json.raw("        \"extension\": ").string(library.videoExtension(v)).raw("\n");
+        json.raw("      }");
+        if (v + 1 < library.videoEnd(course)) json.raw(",");
+        json.raw("\n");
     }
 
-    json << "    ]\n  }\n}";
-    return json.str();
+    json.raw("    ]\n  }\n}");
+    return json.take();
 }
 
-std::string JsonResponse::createVideoResponse(const VideoFile& video) {
-    std::ostringstream json;
-    json << "{\n  \"status\": \"success\",\n  \"data\": {\n";
-    json << "    \"name\": \"" << escapeJson(video.name) << "\",\n";
-    json << "    \"path\": \"" << escapeJson(video.relative_path) << "\",\n";
-    json << "    \"size\": " << video.size << ",\n";
-    json << "    \"extension\": \"" << escapeJson(video.extension) << "\"\n";
-    json << "  }\n}";
-    return json.str();
+std::string JsonResponse::createVideoResponse(const FlatLibrary& library, FlatLibrary::Index video) {
+    JsonWriter json;
+    json.raw("{\n  \"status\": \"success\",\n  \"data\": {\n");
+    json.raw("    \"name\": ").string(library.videoName(video)).raw(",\n");
+    json.raw("    \"path\": ").string(library.videoRelativePath(video)).raw(",\n");
+    json.raw("    \"size\": ").number(library.videoSize(video)).raw(",\n");
+    json.raw("    \"extension\": ").string(library.videoExtension(video)).raw("\n");
+    json.raw("  }\n}");
+    return json.take();
+}
+
+std::string JsonResponse::createSearchResponse(const FlatLibrary& library, std::string_view query,
+                                               const std::vector<FlatLibrary::Index>& videos, size_t total) {
+    JsonWriter json(videos.size() * 320 + 128);
+    json.raw("{\n  \"status\": \"success\",\n  \"data\": {\n");
+    json.raw("    \"query\": ").string(query).raw(",\n");
+    json.raw("    \"total\": ").number(total).raw(",\n");
+    json.raw("    \"results\": [\n");
+
+    for (size_t i = 0; i < videos.size(); ++i) {
+        FlatLibrary::Index video = videos[i];
+        FlatLibrary::Index course = library.videoCourse(video);
+        FlatLibrary::Index semester = library.courseSemester(course);
+        json.raw("      {\n");
+        json.raw("        \"name\": ").string(library.videoName(video)).raw(",\n");
+        json.raw("        \"path\": ").string(library.videoRelativePath(video)).raw(",\n");
+        json.raw("        \"size\": ").number(library.videoSize(video)).raw(",\n");
+        json.raw("        \"extension\": ").string(library.videoExtension(video)).raw(",\n");
+        json.raw("        \"year\": ").string(library.yearName(library.semesterYear(semester))).raw(",\n");
+        json.raw("        \"semester\": ").string(library.semesterName(semester)).raw(",\n");
+        json.raw("        \"course\": ").string(library.courseName(course)).raw("\n");
+        json.raw("      }");
+        if (i < videos.size() - 1) json.raw(",");
+        json.raw("\n");
+    }
+
+    json.raw("    ]\n  }\n}");
+    return json.take();
+}
+
+std::string JsonResponse::createChangesResponse(uint64_t since, uint64_t generation, bool complete,
+                                                const std::vector<ChangeLog::Change>& changes) {
+    JsonWriter json(changes.size() * 192 + 128);
+    json.raw("{\n  \"status\": \"success\",\n  \"data\": {\n");
+    json.raw("    \"since\": ").number(since).raw(",\n");
+    json.raw("    \"generation\": ").number(generation).raw(",\n");
+    json.raw("    \"resync\": ").raw(complete ? "false" : "true").raw(",\n");
+    json.raw("    \"changes\": [\n");
+
+    for (size_t i = 0; i < changes.size(); ++i) {
+        const auto& change = changes[i];
+        json.raw("      {\n");
+        json.raw("        \"generation\": ").number(change.generation).raw(",\n");
+        json.raw("        \"action\": \"").raw(ChangeLog::actionName(change.action)).raw("\",\n");
+        json.raw("        \"type\": \"").raw(ChangeLog::kindName(change.kind)).raw("\",\n");
+        json.raw("        \"path\": ").string(change.path);
+        if (change.kind == ChangeLog::Kind::VIDEO) {
+            json.raw(",\n        \"size\": ").number(change.size);
+        }
+        json.raw("\n      }");
+        if (i < changes.size() - 1) json.raw(",");
+        json.raw("\n");
+    }
+
+    json.raw("    ]\n  }\n}");
+    return json.take();
 }
 
 std::string JsonResponse::createErrorResponse(const std::string& error, int code) {
-    std::ostringstream json;
-    json << "{\n  \"status\": \"error\",\n";
-    json << "  \"code\": " << code << ",\n";
-    json << "  \"message\": \"" << escapeJson(error) << "\"\n}";
-    return json.str();
+    JsonWriter json;
+    json.raw("{\n  \"status\": \"error\",\n");
+    json.raw("  \"code\": ").number(code).raw(",\n");
+    json.raw("  \"message\": ").string(error).raw("\n}");
+    return json.take();
 }
 
 std::string JsonResponse::createSuccessResponse(const std::string& message) {
-    std::ostringstream json;
-    json << "{\n  \"status\": \"success\",\n";
-    json << "  \"message\": \"" << escapeJson(message) << "\"\n}";
-    return json.str();
+    JsonWriter json;
+    json.raw("{\n  \"status\": \"success\",\n");
+    json.raw("  \"message\": ").string(message).raw("\n}");
+    return json.take();
 }
 
-std::string JsonResponse::escapeJson(const std::string& str) {
-    std::string result;
-    for (char c : str) {
-        switch (c) {
-            case '"':  result += "\\\""; break;
-            case '\\': result += "\\\\"; break;
-            case '\b': result += "\\b"; break;
-            case '\f': result += "\\f"; break;
-            case '\n': result += "\\n"; break;
-            case '\r': result += "\\r"; break;
-            case '\t': result += "\\t"; break;
-            default:   result += c; break;
+std::string JsonResponse::createMetricsResponse(const MetricSections& sections) {
+    JsonWriter json(4096);
+    json.raw("{\n  \"status\": \"success\",\n  \"data\": {\n");
+
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const auto& section = sections[i];
+        json.raw("    ").string(section.first).raw(": {\n");
+
+        for (size_t j = 0; j < section.second.size(); ++j) {
+            const auto& metric = section.second[j];
+            json.raw("      ").string(metric.first).raw(": ").number(metric.second);
+            if (j < section.second.size() - 1) json.raw(",");
+            json.raw("\n");
         }
+
+        json.raw("    }");
+        if (i < sections.size() - 1) json.raw(",");
+        json.raw("\n");
     }
+
+    json.raw("  }\n}");
+    return json.take();
+}
+
+std::string JsonResponse::escapeJson(std::string_view str) {
+    std::string result;
+    result.reserve(str.size());
+    JsonWriter::appendEscaped(result, str);
     return result;
 }
 
 std::string JsonResponse::vectorToJson(const std::vector<std::string>& vec) {
-    std::ostringstream json;
-    json << "[";
+    JsonWriter json;
+    json.raw("[");
     for (size_t i = 0; i < vec.size(); ++i) {
-        json << "\"" << escapeJson(vec[i]) << "\"";
-        if (i < vec.size() - 1) json << ", ";
+        json.string(vec[i]);
+        if (i < vec.size() - 1) json.raw(", ");
     }
-    json << "]";
-    return json.str();
+    json.raw("]");
+    return json.take();
 }
 
 } // namespace utec
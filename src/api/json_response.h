@@ -1,21 +1,36 @@
 // src/api/json_response.h
 #pragma once
-#include "utils/types.h"
+#include "api/change_log.h"
+#include "utils/flat_library.h"
 #include <string>
+#include <string_view>
 #include <map>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 namespace utec {
 
+    using MetricSection = std::vector<std::pair<std::string, uint64_t>>;
+    using MetricSections = std::vector<std::pair<std::string, MetricSection>>;
+
     class JsonResponse {
     public:
-        static std::string createLibraryResponse(const VideoLibrary& library);
-        static std::string createCourseResponse(const Course& course);
-        static std::string createVideoResponse(const VideoFile& video);
+        static std::string createLibraryResponse(const FlatLibrary& library);
+        static std::string createCourseResponse(const FlatLibrary& library, FlatLibrary::Index course);
+        static std::string createVideoResponse(const FlatLibrary& library, FlatLibrary::Index video);
+        // total counts every match; videos are the ones returned, best first
+        static std::string createSearchResponse(const FlatLibrary& library, std::string_view query,
+                                                const std::vector<FlatLibrary::Index>& videos, size_t total);
+        // complete = false tells the client to fetch the whole library instead
+        static std::string createChangesResponse(uint64_t since, uint64_t generation, bool complete,
+                                                 const std::vector<ChangeLog::Change>& changes);
         static std::string createErrorResponse(const std::string& error, int code = 500);
         static std::string createSuccessResponse(const std::string& message);
+        static std::string createMetricsResponse(const MetricSections& sections);
 
         // Made public to allow access from other classes
-        static std::string escapeJson(const std::string& str);
+        static std::string escapeJson(std::string_view str);
         static std::string vectorToJson(const std::vector<std::string>& vec);
     };
 
@@ -0,0 +1,85 @@
+// src/api/json_writer.cpp
+#include "api/json_writer.h"
+#include <array>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace utec {
+
+namespace {
+
+// The letter after the backslash, 'u' for \u00XX, or 0 when the byte is copied
+constexpr std::array<char, 256> makeEscapes() {
+    std::array<char, 256> escapes{};
+    for (int c = 0; c < 0x20; ++c) {
+        escapes[c] = 'u';
+    }
+    escapes['\b'] = 'b';
+    escapes['\f'] = 'f';
+    escapes['\n'] = 'n';
+    escapes['\r'] = 'r';
+    escapes['\t'] = 't';
+    escapes['"'] = '"';
+    escapes['\\'] = '\\';
+    return escapes;
+}
+
+constexpr std::array<char, 256> ESCAPES = makeEscapes();
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+// Length of the leading run that is copied as is
+size_t cleanPrefix(const char* data, size_t size) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control_max = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // Unsigned c <= 0x1F exactly when min(c, 0x1F) == c
+        __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+            _mm_cmpeq_epi8(_mm_min_epu8(chunk, control_max), chunk));
+        int mask = _mm_movemask_epi8(special);
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+#endif
+    while (i < size && !ESCAPES[static_cast<unsigned char>(data[i])]) {
+        ++i;
+    }
+    return i;
+}
+
+void appendEscape(std::string& out, unsigned char c) {
+    char escape = ESCAPES[c];
+    if (escape != 'u') {
+        const char sequence[2] = {'\\', escape};
+        out.append(sequence, 2);
+    } else {
+        const char sequence[6] = {'\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0xF]};
+        out.append(sequence, 6);
+    }
+}
+
+} // namespace
+
+void JsonWriter::appendEscaped(std::string& out, std::string_view value) {
+    const char* data = value.data();
+    size_t size = value.size();
+    while (size > 0) {
+        size_t clean = cleanPrefix(data, size);
+        out.append(data, clean);
+        if (clean == size) {
+            break;
+        }
+        appendEscape(out, static_cast<unsigned char>(data[clean]));
+        data += clean + 1;
+        size -= clean + 1;
+    }
+}
+
+} // namespace utec
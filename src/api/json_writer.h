@@ -0,0 +1,54 @@
+// src/api/json_writer.h
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace utec {
+
+    // Appends JSON text to one growing buffer. Callers lay out the document
+    // themselves; the writer only quotes strings and formats numbers, both
+    // without streams or locales.
+    class JsonWriter {
+    public:
+        explicit JsonWriter(size_t reserve = 256) { out_.reserve(reserve); }
+
+        // Room for bytes more, so a known-size document grows once
+        void reserve(size_t bytes) { out_.reserve(out_.size() + bytes); }
+
+        JsonWriter& raw(std::string_view text) {
+            out_.append(text.data(), text.size());
+            return *this;
+        }
+
+        // Quoted and escaped
+        JsonWriter& string(std::string_view value) {
+            out_.push_back('"');
+            appendEscaped(out_, value);
+            out_.push_back('"');
+            return *this;
+        }
+
+        template <typename Integer>
+        JsonWriter& number(Integer value) {
+            static_assert(std::is_integral<Integer>::value, "JsonWriter::number takes integers");
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            out_.append(digits, static_cast<size_t>(result.ptr - digits));
+            return *this;
+        }
+
+        size_t size() const { return out_.size(); }
+        std::string take() { return std::move(out_); }
+
+        // Escapes quotes, backslashes and every control character below
+        // 0x20; runs that need no escaping are copied 16 bytes at a time
+        static void appendEscaped(std::string& out, std::string_view value);
+
+    private:
+        std::string out_;
+    };
+
+} // namespace utec
@@ -0,0 +1,140 @@
+// src/api/library_snapshot.cpp
+#include "api/library_snapshot.h"
+#include "api/json_response.h"
+#include <functional>
+#include <string>
+
+namespace utec {
+
+namespace {
+
+size_t combine(size_t seed, std::string_view value) {
+    return seed ^ (std::hash<std::string_view>()(value) + static_cast<size_t>(0x9e3779b97f4a7c15ULL) +
+                   (seed << 6) + (seed >> 2));
+}
+
+} // namespace
+
+size_t LibrarySnapshot::KeyHash::operator()(const CourseKey& key) const {
+    return combine(combine(std::hash<std::string_view>()(key.year), key.semester), key.course);
+}
+
+void LibrarySnapshot::buildIndex() {
+    courses_.clear();
+    courses_.reserve(library.courseCount());
+
+    for (FlatLibrary::Index c = 0; c < library.courseCount(); ++c) {
+        FlatLibrary::Index semester = library.courseSemester(c);
+        courses_.emplace(CourseKey{library.yearName(library.semesterYear(semester)),
+                                   library.semesterName(semester), library.courseName(c)}, c);
+    }
+}
+
+void LibrarySnapshot::buildResponses(const LibrarySnapshot* previous, bool compress) {
+    compress_ = compress;
+    course_responses_.assign(library.courseCount(), nullptr);
+    if (previous && previous->compress_ == compress) {
+        carryCourseResponses(*previous);
+    }
+
+    // A spliced previous still has the responses of the version before it
+    const LibrarySnapshot* built = previous && previous->built_ ? previous->built_.get() : previous;
+    bool same_library = built && built->compress_ == compress && FlatLibrary::sameVideos(built->library, library);
+
+    library_response_ = same_library && built->library_response_
+        ? built->library_response_
+        : std::make_shared<const EncodedBody>(JsonResponse::createLibraryResponse(library), compress);
+
+    // The index holds video indexes, so it stays valid only while every
+    // video keeps its place, which is what sameVideos() checks
+    search_index_ = same_library && built->search_index_
+        ? built->search_index_
+        : std::make_shared<const SearchIndex>(library);
+    built_.reset();
+}
+
+void LibrarySnapshot::spliceResponses(const std::shared_ptr<const LibrarySnapshot>& previous,
+                                      const std::shared_ptr<const LibrarySnapshot>& built) {
+    compress_ = previous->compress_;
+    course_responses_.assign(library.courseCount(), nullptr);
+    carryCourseResponses(*previous);
+
+    const auto& base = built ? built : previous;
+    library_response_ = base->library_response_;
+    search_index_ = base->search_index_;
+    built_ = base->built_ ? base->built_ : base;
+}
+
+void LibrarySnapshot::carryCourseResponses(const LibrarySnapshot& previous) {
+    // Both course lists are in path order, so one merge pass pairs them up
+    const FlatLibrary& before = previous.library;
+    FlatLibrary::Index c = 0;
+    FlatLibrary::Index p = 0;
+    while (c < library.courseCount() && p < before.courseCount()) {
+        int order = FlatLibrary::compareCourses(library, c, before, p);
+        if (order < 0) {
+            ++c;
+        } else if (order > 0) {
+            ++p;
+        } else {
+            if (FlatLibrary::sameCourse(before, p, library, c)) {
+                course_responses_[c] = std::atomic_load(&previous.course_responses_[p]);
+            }
+            ++c;
+            ++p;
+        }
+    }
+}
+
+std::shared_ptr<const EncodedBody> LibrarySnapshot::courseResponse(FlatLibrary::Index course) const {
+    auto response = std::atomic_load(&course_responses_[course]);
+    if (!response) {
+        // Concurrent first requests may both serialize, and the first copy
+        // stored is kept. Compressing is left to VideoApi's background thread
+        std::shared_ptr<const EncodedBody> expected;
+        response = std::make_shared<const EncodedBody>(JsonResponse::createCourseResponse(library, course), false);
+        if (!std::atomic_compare_exchange_strong(&course_responses_[course], &expected, response)) {
+            response = expected;
+        }
+    }
+    return response;
+}
+
+bool LibrarySnapshot::replaceCourseResponse(FlatLibrary::Index course, std::shared_ptr<const EncodedBody> expected,
+                                            std::shared_ptr<const EncodedBody> replacement) const {
+    return std::atomic_compare_exchange_strong(&course_responses_[course], &expected, std::move(replacement));
+}
+
+size_t LibrarySnapshot::responseBytes() const {
+    size_t bytes = library_response_ ? library_response_->memoryUsage() : 0;
+    for (const auto& slot : course_responses_) {
+        if (auto response = std::atomic_load(&slot)) {
+            bytes += response->memoryUsage();
+        }
+    }
+    return bytes;
+}
+
+FlatLibrary::Index LibrarySnapshot::findCourse(std::string_view year, std::string_view semester,
+                                               std::string_view course) const {
+    auto it = courses_.find(CourseKey{year, semester, course});
+    return it != courses_.end() ? it->second : FlatLibrary::npos;
+}
+
+FlatLibrary::Index LibrarySnapshot::findVideo(std::string_view year, std::string_view semester,
+                                              std::string_view course, std::string_view video) const {
+    FlatLibrary::Index found = findCourse(year, semester, course);
+    if (found == FlatLibrary::npos) {
+        return FlatLibrary::npos;
+    }
+    // A course lists few videos, and an index of every name would have to
+    // be rebuilt whenever a course is spliced in
+    for (FlatLibrary::Index v = library.videoBegin(found); v < library.videoEnd(found); ++v) {
+        if (library.videoName(v) == video) {
+            return v;
+        }
+    }
+    return FlatLibrary::npos;
+}
+
+} // namespace utec
@@ -0,0 +1,102 @@
+// src/api/library_snapshot.h
+#pragma once
+#include "utils/flat_library.h"
+#include "utils/encoded_body.h"
+#include "api/search_index.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace utec {
+
+    // One version of the library. It is never modified once published:
+    // readers keep the shared_ptr for as long as they use it, and updates
+    // build a new snapshot next to it.
+    struct LibrarySnapshot {
+        FlatLibrary library;
+        uint64_t generation = 0;
+        long long generation_time = 0;  // unix seconds
+        long long epoch = 0;            // start of the run that produced this generation
+        long long modified_time = 0;    // unix seconds; the last change to a course or video body
+
+        LibrarySnapshot() = default;
+        // The indexes point into the library's names, so a copy would point into the original
+        LibrarySnapshot(const LibrarySnapshot&) = delete;
+        LibrarySnapshot& operator=(const LibrarySnapshot&) = delete;
+
+        // Called once the library is final, before the snapshot is published
+        void buildIndex();
+
+        // Serializes the library response, or takes previous's when nothing
+        // in it changed; course responses of unchanged courses are carried
+        // over too. previous may be null. With compress, every body also
+        // gets its compressed variants when it is serialized
+        void buildResponses(const LibrarySnapshot* previous, bool compress);
+
+        // For a library that differs from previous's in a few courses: only
+        // the course responses are carried over. The library response and
+        // the search index are built's, or previous's without it, as they
+        // are, so they still describe the last version built in full, which
+        // this snapshot keeps until a later one is built with buildResponses()
+        void spliceResponses(const std::shared_ptr<const LibrarySnapshot>& previous,
+                             const std::shared_ptr<const LibrarySnapshot>& built = nullptr);
+        bool spliced() const { return built_ != nullptr; }
+
+        // Name search over the library indexedLibrary() returns; built with
+        // the responses, or taken from previous when no video changed
+        const SearchIndex& searchIndex() const { return *search_index_; }
+        // The library the library response and the search index describe
+        const FlatLibrary& indexedLibrary() const { return built_ ? built_->library : library; }
+
+        // Serialized bodies, shared by every request for this snapshot. A
+        // course is serialized by the first request for it, without the
+        // compressed variants, and then kept for as long as the course does
+        // not change
+        std::shared_ptr<const EncodedBody> libraryResponse() const { return library_response_; }
+        std::shared_ptr<const EncodedBody> courseResponse(FlatLibrary::Index course) const;
+        // Swaps the course's response for replacement while it is still
+        // expected, so variants compressed off the request path replace the
+        // body they were made from and nothing newer
+        bool replaceCourseResponse(FlatLibrary::Index course, std::shared_ptr<const EncodedBody> expected,
+                                   std::shared_ptr<const EncodedBody> replacement) const;
+        size_t responseBytes() const;  // every variant of the serialized bodies
+
+        // Courses are hashed by display name and the first match wins, as
+        // with a scan; a video is looked for in its course's listing.
+        // FlatLibrary::npos when there is no such entry
+        FlatLibrary::Index findCourse(std::string_view year, std::string_view semester,
+                                      std::string_view course) const;
+        FlatLibrary::Index findVideo(std::string_view year, std::string_view semester,
+                                     std::string_view course, std::string_view video) const;
+
+    private:
+        // Views into the library's name arena; lookups need no temporary strings
+        struct CourseKey {
+            std::string_view year;
+            std::string_view semester;
+            std::string_view course;
+            bool operator==(const CourseKey& other) const {
+                return course == other.course && semester == other.semester && year == other.year;
+            }
+        };
+        struct KeyHash {
+            size_t operator()(const CourseKey& key) const;
+        };
+
+        std::unordered_map<CourseKey, FlatLibrary::Index, KeyHash> courses_;
+
+        bool compress_ = false;
+        std::shared_ptr<const EncodedBody> library_response_;
+        std::shared_ptr<const SearchIndex> search_index_;
+        std::shared_ptr<const LibrarySnapshot> built_;  // after spliceResponses(): the version the above describe
+        // One per course, empty until requested; std::atomic_load / std::atomic_store only
+        mutable std::vector<std::shared_ptr<const EncodedBody>> course_responses_;
+
+        void carryCourseResponses(const LibrarySnapshot& previous);
+    };
+
+} // namespace utec
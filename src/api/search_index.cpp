@@ -0,0 +1,305 @@
+// src/api/search_index.cpp
+#include "api/search_index.h"
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <unordered_map>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace utec {
+
+namespace {
+
+enum Rank : uint8_t { EXACT, PREFIX, WORD_START, SUBSTRING, NO_MATCH };
+
+struct Match {
+    uint8_t rank;
+    uint32_t length;
+    uint32_t id;  // ids follow the first appearance in the library
+
+    bool operator<(const Match& other) const {
+        if (rank != other.rank) return rank < other.rank;
+        if (length != other.length) return length < other.length;
+        return id < other.id;
+    }
+};
+
+// ASCII only, whatever the locale; other bytes of UTF-8 names stay as they are
+char lower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// The three bytes from position on, with zeros past the end of text
+uint32_t trigramKey(std::string_view text, size_t position) {
+    uint32_t key = 0;
+    for (size_t i = position; i < position + 3; ++i) {
+        key = key << 8 | (i < text.size() ? static_cast<unsigned char>(text[i]) : 0u);
+    }
+    return key;
+}
+
+// First element of the ascending [first, last) not below value; steps
+// doubling from first, so it is cheap when the answer is close
+const uint32_t* gallop(const uint32_t* first, const uint32_t* last, uint32_t value) {
+    if (first == last || *first >= value) {
+        return first;
+    }
+    ptrdiff_t step = 1;
+    while (step < last - first && first[step] < value) {
+        first += step;
+        step <<= 1;
+    }
+    return std::lower_bound(first + 1, step < last - first ? first + step + 1 : last, value);
+}
+
+// Position of the lowest set bit; bits is not zero
+unsigned lowestBit(uint64_t bits) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long position;
+    _BitScanForward64(&position, bits);
+    return static_cast<unsigned>(position);
+#elif defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#else
+    unsigned position = 0;
+    while ((bits & 1) == 0) {
+        bits >>= 1;
+        ++position;
+    }
+    return position;
+#endif
+}
+
+bool isWordByte(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || static_cast<unsigned char>(c) >= 0x80;
+}
+
+Rank rankMatch(std::string_view name, std::string_view query) {
+    size_t position = name.find(query);
+    if (position == std::string_view::npos) {
+        return NO_MATCH;
+    }
+    if (position == 0) {
+        return name.size() == query.size() ? EXACT : PREFIX;
+    }
+    for (; position != std::string_view::npos; position = name.find(query, position + 1)) {
+        if (!isWordByte(name[position - 1])) {
+            return WORD_START;
+        }
+    }
+    return SUBSTRING;
+}
+
+} // namespace
+
+SearchIndex::SearchIndex(const FlatLibrary& library) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Names repeat across courses (Week_01_LAB.mp4 ...), so each distinct
+    // name is lowercased and indexed once
+    std::unordered_map<std::string_view, uint32_t> ids;
+    std::vector<uint32_t> video_names(library.videoCount());
+    std::vector<std::string_view> originals;
+    for (Index v = 0; v < library.videoCount(); ++v) {
+        auto inserted = ids.emplace(library.videoName(v), static_cast<uint32_t>(originals.size()));
+        if (inserted.second) {
+            originals.push_back(library.videoName(v));
+        }
+        video_names[v] = inserted.first->second;
+    }
+
+    name_offsets_.reserve(originals.size() + 1);
+    size_t total_length = 0;
+    for (auto original : originals) {
+        total_length += original.size();
+    }
+    names_.reserve(total_length);
+    for (auto original : originals) {
+        name_offsets_.push_back(static_cast<uint32_t>(names_.size()));
+        for (char c : original) {
+            names_.push_back(lower(c));
+        }
+    }
+    name_offsets_.push_back(static_cast<uint32_t>(names_.size()));
+
+    // Videos grouped by name with a counting sort, which keeps library order
+    name_first_video_.assign(originals.size() + 1, 0);
+    for (uint32_t id : video_names) {
+        ++name_first_video_[id + 1];
+    }
+    for (size_t i = 1; i < name_first_video_.size(); ++i) {
+        name_first_video_[i] += name_first_video_[i - 1];
+    }
+    videos_.resize(video_names.size());
+    std::vector<Index> next(name_first_video_.begin(), name_first_video_.end() - 1);
+    for (Index v = 0; v < video_names.size(); ++v) {
+        videos_[next[video_names[v]]++] = v;
+    }
+
+    // Every position starts a trigram, the last two padded with zeros, so
+    // the prefixes also cover one and two byte queries. The (trigram, name)
+    // pairs come in name order and the radix sort below is stable, which
+    // leaves each posting list ascending
+    std::vector<uint64_t> pairs;
+    pairs.reserve(names_.size());
+    std::vector<uint32_t> keys;
+    for (uint32_t id = 0; id < originals.size(); ++id) {
+        std::string_view text = name(id);
+        keys.clear();
+        for (size_t i = 0; i < text.size(); ++i) {
+            keys.push_back(trigramKey(text, i));
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        for (uint32_t key : keys) {
+            pairs.push_back(static_cast<uint64_t>(key) << 32 | id);
+        }
+    }
+
+    // Two counting passes of 12 bits cover the 24-bit trigram
+    std::vector<uint64_t> sorted(pairs.size());
+    for (int shift : {32, 44}) {
+        std::vector<size_t> starts(4097, 0);
+        for (uint64_t pair : pairs) {
+            ++starts[((pair >> shift) & 0xFFF) + 1];
+        }
+        for (size_t i = 1; i < starts.size(); ++i) {
+            starts[i] += starts[i - 1];
+        }
+        for (uint64_t pair : pairs) {
+            sorted[starts[(pair >> shift) & 0xFFF]++] = pair;
+        }
+        pairs.swap(sorted);
+    }
+
+    postings_.reserve(pairs.size());
+    for (uint64_t pair : pairs) {
+        auto key = static_cast<uint32_t>(pair >> 32);
+        if (trigrams_.empty() || trigrams_.back() != key) {
+            trigrams_.push_back(key);
+            posting_offsets_.push_back(static_cast<uint32_t>(postings_.size()));
+        }
+        postings_.push_back(static_cast<uint32_t>(pair));
+    }
+    posting_offsets_.push_back(static_cast<uint32_t>(postings_.size()));
+
+    build_time_us_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+std::vector<uint32_t> SearchIndex::candidates(std::string_view query) const {
+    std::vector<uint32_t> result;
+    if (query.size() < 3) {
+        // The names are those listed under any trigram starting with the
+        // query, a contiguous run of trigrams_; they all contain it
+        uint32_t low = trigramKey(query, 0);
+        uint32_t high = low | (query.size() == 1 ? 0xFFFFu : 0xFFu);
+        size_t first = static_cast<size_t>(std::lower_bound(trigrams_.begin(), trigrams_.end(), low) - trigrams_.begin());
+        size_t last = static_cast<size_t>(std::upper_bound(trigrams_.begin(), trigrams_.end(), high) - trigrams_.begin());
+
+        std::vector<uint64_t> seen((name_offsets_.size() + 63) / 64);
+        for (uint32_t p = posting_offsets_[first]; p < posting_offsets_[last]; ++p) {
+            seen[postings_[p] >> 6] |= uint64_t{1} << (postings_[p] & 63);
+        }
+        for (size_t word = 0; word < seen.size(); ++word) {
+            for (uint64_t bits = seen[word]; bits != 0; bits &= bits - 1) {
+                result.push_back(static_cast<uint32_t>(word * 64 + lowestBit(bits)));
+            }
+        }
+        return result;
+    }
+
+    std::vector<uint32_t> keys;
+    for (size_t i = 0; i + 3 <= query.size(); ++i) {
+        keys.push_back(trigramKey(query, i));
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    struct Range { const uint32_t* begin; const uint32_t* end; };
+    std::vector<Range> lists;
+    for (uint32_t key : keys) {
+        auto it = std::lower_bound(trigrams_.begin(), trigrams_.end(), key);
+        if (it == trigrams_.end() || *it != key) {
+            return result;
+        }
+        size_t t = static_cast<size_t>(it - trigrams_.begin());
+        lists.push_back({postings_.data() + posting_offsets_[t], postings_.data() + posting_offsets_[t + 1]});
+    }
+
+    // Shortest list first keeps every intermediate result small
+    std::sort(lists.begin(), lists.end(), [](const Range& a, const Range& b) {
+        return a.end - a.begin < b.end - b.begin;
+    });
+    result.assign(lists[0].begin, lists[0].end);
+    for (size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+        auto kept = result.begin();
+        const uint32_t* cursor = lists[i].begin;
+        for (uint32_t id : result) {
+            cursor = gallop(cursor, lists[i].end, id);
+            if (cursor == lists[i].end) {
+                break;
+            }
+            if (*cursor == id) {
+                *kept++ = id;
+            }
+        }
+        result.erase(kept, result.end());
+    }
+    return result;
+}
+
+SearchIndex::Result SearchIndex::search(std::string_view query, size_t limit) const {
+    Result result;
+    std::string lowered;
+    lowered.reserve(query.size());
+    for (char c : query) {
+        lowered.push_back(lower(c));
+    }
+    // No name contains a zero byte; the index uses it as padding
+    if (lowered.empty() || lowered.find('\0') != std::string::npos) {
+        return result;
+    }
+
+    // Longer queries only narrow the names down; each one is checked
+    std::vector<Match> matches;
+    for (uint32_t id : candidates(lowered)) {
+        std::string_view text = name(id);
+        Rank rank = rankMatch(text, lowered);
+        if (rank == NO_MATCH) {
+            continue;
+        }
+        matches.push_back({static_cast<uint8_t>(rank), static_cast<uint32_t>(text.size()), id});
+        result.total += name_first_video_[id + 1] - name_first_video_[id];
+    }
+
+    // Every name has at least one video, so the best limit names are enough
+    size_t ranked = std::min(limit, matches.size());
+    std::partial_sort(matches.begin(), matches.begin() + static_cast<std::ptrdiff_t>(ranked), matches.end());
+    for (size_t i = 0; i < ranked && result.videos.size() < limit; ++i) {
+        uint32_t id = matches[i].id;
+        for (Index v = name_first_video_[id]; v < name_first_video_[id + 1] && result.videos.size() < limit; ++v) {
+            result.videos.push_back(videos_[v]);
+        }
+    }
+    return result;
+}
+
+SearchIndex::Stats SearchIndex::stats() const {
+    Stats stats;
+    stats.names = name_offsets_.size() - 1;
+    stats.trigrams = trigrams_.size();
+    stats.postings = postings_.size();
+    stats.memory_bytes = sizeof(*this) + names_.capacity() +
+                         name_offsets_.capacity() * sizeof(uint32_t) +
+                         name_first_video_.capacity() * sizeof(Index) + videos_.capacity() * sizeof(Index) +
+                         trigrams_.capacity() * sizeof(uint32_t) + posting_offsets_.capacity() * sizeof(uint32_t) +
+                         postings_.capacity() * sizeof(uint32_t);
+    stats.build_time_us = build_time_us_;
+    return stats;
+}
+
+} // namespace utec
@@ -0,0 +1,62 @@
+// src/api/search_index.h
+#pragma once
+#include "utils/flat_library.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace utec {
+
+    // Substring search over the video names of one library version. Each
+    // distinct name is stored once, lowercased, and listed under every
+    // three-byte sequence it contains; a query only checks the names that
+    // have all of its trigrams, and a shorter one takes the names under the
+    // trigrams it starts. Matching ignores ASCII case and works on the
+    // UTF-8 bytes.
+    class SearchIndex {
+    public:
+        struct Stats {
+            uint64_t names = 0;      // distinct video names
+            uint64_t trigrams = 0;
+            uint64_t postings = 0;
+            uint64_t memory_bytes = 0;
+            uint64_t build_time_us = 0;
+        };
+
+        struct Result {
+            std::vector<FlatLibrary::Index> videos;  // best first, at most the limit
+            size_t total = 0;                        // every matching video
+        };
+
+        explicit SearchIndex(const FlatLibrary& library);
+
+        // Videos whose name contains query. Exact names rank first, then
+        // names starting with it, then matches at the start of a word, then
+        // the rest; shorter names first within each, then library order
+        Result search(std::string_view query, size_t limit) const;
+
+        Stats stats() const;
+
+    private:
+        using Index = FlatLibrary::Index;
+
+        std::string names_;                      // lowercased, back to back
+        std::vector<uint32_t> name_offsets_;     // name i is [offsets[i], offsets[i + 1])
+        std::vector<Index> name_first_video_;    // the videos of name i, as a range of videos_
+        std::vector<Index> videos_;              // grouped by name, in library order
+
+        std::vector<uint32_t> trigrams_;         // sorted
+        std::vector<uint32_t> posting_offsets_;  // trigram i lists postings_[offsets[i] .. offsets[i + 1])
+        std::vector<uint32_t> postings_;         // name ids, ascending per trigram
+
+        uint64_t build_time_us_ = 0;
+
+        std::string_view name(uint32_t id) const {
+            return std::string_view(names_).substr(name_offsets_[id], name_offsets_[id + 1] - name_offsets_[id]);
+        }
+        std::vector<uint32_t> candidates(std::string_view query) const;
+    };
+
+} // namespace utec
@@ -4,118 +4,549 @@
 #include "api/video_api.h"
 #include "api/json_response.h"
 #include "filesystem/directory_scanner.h"
+#include "filesystem/library_index.h"
+#include "filesystem/library_poller.h"
+#include "filesystem/library_watcher.h"
 #include "utils/logger.h"
-#include "utils/string_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace utec {
 
-VideoApi::VideoApi(std::shared_ptr<DirectoryScanner> scanner)
-    : scanner_(scanner), cache_valid_(false) {
+namespace {
+
+// Changes that come in this soon after the first one are published together
+constexpr auto PUBLISH_DELAY = std::chrono::seconds(1);
+
+// Course bodies waiting for their compressed variants; beyond this they are
+// queued again by a later request
+constexpr size_t MAX_QUEUED_COMPRESSIONS = 1024;
+
+long long unixNow() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
-std::string VideoApi::getLibrary() {
-    refreshCache();
-    return JsonResponse::createLibraryResponse(cached_library_);
+} // namespace
+
+VideoApi::VideoApi(std::shared_ptr<DirectoryScanner> scanner, size_t change_log_size, bool compress_responses)
+    : scanner_(scanner), process_epoch_(unixNow()), compress_responses_(compress_responses),
+      change_log_(change_log_size) {
 }
 
-std::string VideoApi::getCourse(const std::string& year, const std::string& semester, const std::string& course) {
-    refreshCache();
+VideoApi::~VideoApi() {
+    stopWatching();
+}
 
-    for (const auto& y : cached_library_) {
-        if (y.year == year) {
-            for (const auto& s : y.semesters) {
-                if (s.name == semester) {
-                    for (const auto& c : s.courses) {
-                        if (c.name == course) {
-                            return JsonResponse::createCourseResponse(c);
-                        }
-                    }
-                }
-            }
+std::shared_ptr<const EncodedBody> VideoApi::getLibrary() {
+    return snapshot()->libraryResponse();
+}
+
+std::shared_ptr<const EncodedBody> VideoApi::getCourse(std::string_view year, std::string_view semester,
+                                                       std::string_view course) {
+    auto current = snapshotWithCourse(year, semester, course);
+
+    auto found_course = current->findCourse(year, semester, course);
+    if (found_course != FlatLibrary::npos) {
+        auto response = current->courseResponse(found_course);
+        if (compress_responses_ && !response->compressed()) {
+            // Served as it is until the variants are ready
+            scheduleCompression(*current, found_course, response);
         }
+        return response;
     }
 
-    return JsonResponse::createErrorResponse("Course not found", 404);
+    return std::make_shared<const EncodedBody>(JsonResponse::createErrorResponse("Course not found", 404), false);
 }
 
-std::string VideoApi::getVideo(const std::string& year, const std::string& semester,
-                              const std::string& course, const std::string& video) {
-    refreshCache();
+std::string VideoApi::getVideo(std::string_view year, std::string_view semester,
+                              std::string_view course, std::string_view video) {
+    auto current = snapshotWithCourse(year, semester, course);
 
-    VideoFile* found_video = findVideo(year, semester, course, video);
-    if (found_video) {
-        return JsonResponse::createVideoResponse(*found_video);
+    auto found_video = current->findVideo(year, semester, course, video);
+    if (found_video != FlatLibrary::npos) {
+        return JsonResponse::createVideoResponse(current->library, found_video);
     }
 
     return JsonResponse::createErrorResponse("Video not found", 404);
 }
 
-std::string VideoApi::searchVideos(const std::string& query) {
-    refreshCache();
+std::string VideoApi::searchVideos(std::string_view query, size_t limit) {
+    auto current = snapshot();
+
+    auto result = current->searchIndex().search(query, limit);
+    return JsonResponse::createSearchResponse(current->indexedLibrary(), query, result.videos, result.total);
+}
+
+std::string VideoApi::getChanges(uint64_t since) {
+    auto current = snapshot();
+
+    // The log may already hold the next generation; only changes up to the
+    // snapshot are reported, so the answer matches /api/library
+    std::vector<ChangeLog::Change> changes;
+    bool complete = change_log_.changesSince(since, current->generation, changes);
+    return JsonResponse::createChangesResponse(since, current->generation, complete, changes);
+}
+
+std::string VideoApi::getETag() {
+    auto current = snapshot();
+
+    // The run's start time keeps tags from another run from matching
+    char etag[48];
+    std::snprintf(etag, sizeof(etag), "\"lib-%llx-%llx\"",
+                  static_cast<unsigned long long>(current->epoch),
+                  static_cast<unsigned long long>(current->generation));
+    return etag;
+}
+
+long long VideoApi::getLastModified() {
+    return snapshot()->generation_time;
+}
+
+long long VideoApi::getContentModified() {
+    return snapshot()->modified_time;
+}
+
+std::shared_ptr<const LibrarySnapshot> VideoApi::snapshot() {
+    auto current = std::atomic_load(&snapshot_);
+    if (current) {
+        return current;
+    }
+
+    // Only the very first requests wait, for the initial scan
+    std::lock_guard<std::mutex> lock(update_mutex_);
+    current = std::atomic_load(&snapshot_);
+    if (current) {
+        return current;
+    }
+
+    // Requests are waiting for this scan, so it is not throttled
+    Logger::debug("Refreshing video library cache");
+    if (poller_ && !scanner_->isLazy()) {
+        // Anything that changes during the scan is then seen by the next refresh;
+        // a lazy scan leaves the poller to list the courses in the background
+        poller_->ensureBaseline(false);
+    }
+    auto scanned = std::make_shared<LibrarySnapshot>();
+    scanned->library = FlatLibrary(scanner_->getRootPath(), scanner_->scanLibrary(false));
+    scanned->generation = 1;
+    scanned->generation_time = unixNow();
+    scanned->modified_time = scanned->generation_time;
+    scanned->epoch = process_epoch_;
+    change_log_.reset(scanned->generation);
+    publish(scanned);
+    saveIndex(*scanned);
+    return scanned;
+}
+
+void VideoApi::publish(std::shared_ptr<LibrarySnapshot> snapshot) {
+    snapshot->buildIndex();
+    // Called with update_mutex_ held or before anything is served, so the
+    // current snapshot is the one this replaces
+    snapshot->buildResponses(std::atomic_load(&snapshot_).get(), compress_responses_);
+    // Readers that loaded the previous snapshot keep it until they are done
+    std::atomic_store(&snapshot_, std::shared_ptr<const LibrarySnapshot>(std::move(snapshot)));
+}
+
+void VideoApi::saveIndex(const LibrarySnapshot& snapshot) {
+    if (!index_path_.empty()) {
+        LibraryIndex::Info info;
+        info.epoch = snapshot.epoch;
+        info.generation = snapshot.generation;
+        info.generation_time = snapshot.generation_time;
+        LibraryIndex::save(index_path_, scanner_->getRootPath(), snapshot.library, info);
+    }
+}
+
+bool VideoApi::loadIndex(const std::string& path) {
+    std::lock_guard<std::mutex> lock(update_mutex_);
+    index_path_ = path;
+    if (std::atomic_load(&snapshot_)) {
+        return false;
+    }
+
+    auto loaded = std::make_shared<LibrarySnapshot>();
+    LibraryIndex::Info info;
+    if (!LibraryIndex::load(path, scanner_->getRootPath(), loaded->library, info)) {
+        return false;
+    }
+
+    // Same listing as when it was saved, so clients keep their cached copies
+    loaded->epoch = info.epoch;
+    loaded->generation = info.generation;
+    loaded->generation_time = info.generation_time;
+    loaded->modified_time = info.generation_time;
+    change_log_.reset(loaded->generation);
+    publish(loaded);
+    return true;
+}
+
+void VideoApi::verifyIndex() {
+    if (verify_thread_.joinable()) {
+        return;
+    }
+
+    verify_thread_ = std::thread([this]() {
+        try {
+            if (poller_ && !scanner_->isLazy()) {
+                poller_->ensureBaseline();
+            }
+
+            auto current = std::atomic_load(&snapshot_);
+            if (!current) {
+                return;
+            }
+            auto start = std::chrono::steady_clock::now();
+            auto changed = scanner_->findChanges(current->library);
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            Logger::info("Library index checked in " + std::to_string(elapsed) + " ms, " +
+                         std::to_string(changed.size()) + " paths to rescan");
+            if (!changed.empty()) {
+                applyChanges(changed);
+            }
+        } catch (const std::exception& e) {
+            Logger::error("Library index check failed: " + std::string(e.what()));
+        }
+    });
+}
+
+bool VideoApi::startWatching(std::chrono::milliseconds coalesce_delay, std::chrono::milliseconds max_delay) {
+    if (watcher_) {
+        return true;
+    }
+
+    auto watcher = std::make_shared<LibraryWatcher>(
+        scanner_->getRootPath(), coalesce_delay, max_delay,
+        [this](const std::vector<std::string>& changed_paths) { applyChanges(changed_paths); });
+    if (!watcher->start()) {
+        return false;
+    }
+    watcher_ = watcher;
+    return true;
+}
+
+void VideoApi::startPolling(std::chrono::seconds interval) {
+    if (poller_) {
+        return;
+    }
+
+    poller_ = std::make_shared<LibraryPoller>(
+        scanner_->getRootPath(), interval,
+        [this](const std::vector<std::string>& changed_paths) { applyChanges(changed_paths); },
+        scanner_->getThrottle());
+    poller_->start();
+}
+
+void VideoApi::stopWatching() {
+    if (watcher_) {
+        watcher_->stop();
+    }
+    if (poller_) {
+        poller_->stop();
+    }
+    if (verify_thread_.joinable()) {
+        verify_thread_.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(crawl_mutex_);
+        crawl_stopping_ = true;
+    }
+    crawl_wake_.notify_all();
+    if (crawl_thread_.joinable()) {
+        crawl_thread_.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(publish_mutex_);
+        publish_stopping_ = true;
+    }
+    // A pending publish is finished first, so the saved index is current
+    publish_wake_.notify_all();
+    if (publish_thread_.joinable()) {
+        publish_thread_.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(compress_mutex_);
+        compress_stopping_ = true;
+    }
+    compress_wake_.notify_all();
+    if (compress_thread_.joinable()) {
+        compress_thread_.join();
+    }
+}
+
+void VideoApi::applyChanges(const std::vector<std::string>& changed_paths) {
+    auto base = std::atomic_load(&snapshot_);
+    if (!base) {
+        // Nothing served yet; the first request scans the current tree anyway
+        return;
+    }
+
+    // Listed at the throttle's pace without update_mutex_, so requests that
+    // list a course meanwhile are not held up
+    FlatLibrary rescanned = scanner_->rescan(base->library, changed_paths, true);
+
+    std::lock_guard<std::mutex> lock(update_mutex_);
+    auto current = std::atomic_load(&snapshot_);
+    if (current != base) {
+        // Another update came first: only the courses this rescan changed
+        // are carried over, so nothing is listed again under the lock
+        rescanned = FlatLibrary::merge(base->library, current->library, rescanned);
+    }
+    splice(current, std::move(rescanned));
+}
+
+void VideoApi::splice(const std::shared_ptr<const LibrarySnapshot>& current, FlatLibrary library) {
+    // Same generation until the publish: the library response, the change
+    // log and the library's validators all move to the next one together.
+    // Course and video bodies change now, so their date moves now
+    auto updated = std::make_shared<LibrarySnapshot>();
+    updated->library = std::move(library);
+    updated->epoch = current->epoch;
+    updated->generation = current->generation;
+    updated->generation_time = current->generation_time;
+    updated->modified_time = unixNow();
+    updated->buildIndex();
+    updated->spliceResponses(current);
+    std::atomic_store(&snapshot_, std::shared_ptr<const LibrarySnapshot>(std::move(updated)));
+    schedulePublish();
+}
+
+void VideoApi::schedulePublish(bool immediately) {
+    std::lock_guard<std::mutex> lock(publish_mutex_);
+    if (publish_stopping_) {
+        // Shutting down; the next start checks the saved index against the disk
+        return;
+    }
+    if (!publish_thread_.joinable()) {
+        publish_thread_ = std::thread([this]() { runPublisher(); });
+    }
+    if (!publish_pending_ || immediately) {
+        publish_pending_ = true;
+        publish_due_ = std::chrono::steady_clock::now() + (immediately ? std::chrono::seconds(0) : PUBLISH_DELAY);
+        publish_wake_.notify_all();
+    }
+}
+
+void VideoApi::runPublisher() {
+    while (true) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(publish_mutex_);
+            publish_wake_.wait(lock, [this]() { return publish_pending_ || publish_stopping_; });
+            publish_wake_.wait_until(lock, publish_due_, [this]() { return publish_stopping_; });
+            if (!publish_pending_) {
+                return;
+            }
+            publish_pending_ = false;
+            stopping = publish_stopping_;
+        }
+
+        try {
+            publishSplices();
+        } catch (const std::exception& e) {
+            Logger::error("Library publish failed: " + std::string(e.what()));
+        }
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+void VideoApi::publishSplices() {
+    auto current = std::atomic_load(&snapshot_);
+    if (!current || !current->spliced()) {
+        return;
+    }
+
+    // Built without update_mutex_, so courses can still be listed meanwhile
+    const FlatLibrary& before = current->indexedLibrary();
+    auto updated = std::make_shared<LibrarySnapshot>();
+    updated->library = current->library;
+    bool changed = !FlatLibrary::sameVideos(before, updated->library);
+    if (changed) {
+        // A tag from the loaded index could have been handed out by the
+        // previous run for a later library that was never saved
+        updated->epoch = process_epoch_;
+        updated->generation = current->generation + 1;
+        updated->generation_time = unixNow();
+        updated->modified_time = updated->generation_time;
+    } else {
+        updated->epoch = current->epoch;
+        updated->generation = current->generation;
+        updated->generation_time = current->generation_time;
+        updated->modified_time = current->modified_time;
+    }
+    updated->buildIndex();
+    updated->buildResponses(current.get(), compress_responses_);
+
+    {
+        std::lock_guard<std::mutex> lock(update_mutex_);
+        if (changed) {
+            change_log_.record(updated->generation, before, updated->library);
+        }
+        auto latest = std::atomic_load(&snapshot_);
+        if (latest == current) {
+            std::atomic_store(&snapshot_, std::shared_ptr<const LibrarySnapshot>(updated));
+        } else {
+            // Courses were spliced in meanwhile. They go on top of what was
+            // built instead of into a new build, which steady splicing would
+            // never let finish; their splice has scheduled the next publish
+            auto spliced = std::make_shared<LibrarySnapshot>();
+            spliced->library = latest->library;
+            spliced->epoch = updated->epoch;
+            spliced->generation = updated->generation;
+            spliced->generation_time = updated->generation_time;
+            spliced->modified_time = std::max(latest->modified_time, updated->modified_time);
+            spliced->buildIndex();
+            spliced->spliceResponses(latest, updated);
+            std::atomic_store(&snapshot_, std::shared_ptr<const LibrarySnapshot>(std::move(spliced)));
+        }
+    }
+    if (changed) {
+        Logger::info("Library updated to generation " + std::to_string(updated->generation));
+    }
+
+    // Saved even when only mtimes moved, so the next start checks less
+    saveIndex(*updated);
+}
+
+void VideoApi::scheduleCompression(const LibrarySnapshot& snapshot, FlatLibrary::Index course,
+                                   std::shared_ptr<const EncodedBody> body) {
+    std::lock_guard<std::mutex> lock(compress_mutex_);
+    if (compress_stopping_ || compress_queue_.size() >= MAX_QUEUED_COMPRESSIONS ||
+        !compress_queued_.insert(body.get()).second) {
+        return;
+    }
+    if (!compress_thread_.joinable()) {
+        compress_thread_ = std::thread([this]() { runCompressor(); });
+    }
+
+    const FlatLibrary& library = snapshot.library;
+    FlatLibrary::Index semester = library.courseSemester(course);
+    compress_queue_.push_back(Compression{std::string(library.yearName(library.semesterYear(semester))),
+                                          std::string(library.semesterName(semester)),
+                                          std::string(library.courseName(course)), std::move(body)});
+    compress_wake_.notify_one();
+}
+
+void VideoApi::runCompressor() {
+#ifdef __linux__
+    // Requests come first; until this catches up they get identity bodies
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+#endif
 
-    std::string lower_query = StringUtils::toLower(query);
-    std::vector<VideoFile> results;
+    while (true) {
+        Compression job;
+        {
+            std::unique_lock<std::mutex> lock(compress_mutex_);
+            compress_wake_.wait(lock, [this]() { return !compress_queue_.empty() || compress_stopping_; });
+            if (compress_stopping_) {
+                return;
+            }
+            job = std::move(compress_queue_.front());
+            compress_queue_.pop_front();
+        }
 
-    for (const auto& year : cached_library_) {
-        for (const auto& semester : year.semesters) {
-            for (const auto& course : semester.courses) {
-                for (const auto& video : course.videos) {
-                    std::string lower_name = StringUtils::toLower(video.name);
-                    if (lower_name.find(lower_query) != std::string::npos) {
-                        results.push_back(video);
-                    }
+        try {
+            auto compressed = std::make_shared<const EncodedBody>(job.body->identity(), true);
+            // A publish meanwhile may have carried the body over to a newer snapshot
+            auto target = std::atomic_load(&snapshot_);
+            while (true) {
+                auto course = target->findCourse(job.year, job.semester, job.course);
+                if (course != FlatLibrary::npos) {
+                    target->replaceCourseResponse(course, job.body, compressed);
                 }
+                auto latest = std::atomic_load(&snapshot_);
+                if (latest == target) {
+                    break;
+                }
+                target = latest;
             }
+        } catch (const std::exception& e) {
+            Logger::error("Course body compression failed: " + std::string(e.what()));
         }
+
+        std::lock_guard<std::mutex> lock(compress_mutex_);
+        compress_queued_.erase(job.body.get());
     }
+}
+
+std::shared_ptr<const LibrarySnapshot> VideoApi::snapshotWithCourse(std::string_view year,
+                                                                    std::string_view semester,
+                                                                    std::string_view course) {
+    auto current = snapshot();
+    auto found = current->findCourse(year, semester, course);
+    if (found == FlatLibrary::npos || current->library.courseScanned(found)) {
+        return current;
+    }
+
+    // Concurrent requests for the same course wait for one listing, which
+    // the throttle does not hold up
+    std::lock_guard<std::mutex> lock(update_mutex_);
+    current = std::atomic_load(&snapshot_);
+    found = current->findCourse(year, semester, course);
+    if (found != FlatLibrary::npos && !current->library.courseScanned(found)) {
+        splice(current, scanner_->rescan(current->library, {current->library.coursePath(found)}, false));
+        current = std::atomic_load(&snapshot_);
+    }
+    return current;
+}
+
+void VideoApi::startCrawling(size_t batch, std::chrono::milliseconds delay) {
+    if (crawl_thread_.joinable() || batch == 0) {
+        return;
+    }
+
+    crawl_stopping_ = false;
+    crawl_thread_ = std::thread([this, batch, delay]() { crawl(batch, delay); });
+}
+
+void VideoApi::crawl(size_t batch, std::chrono::milliseconds delay) {
+#ifdef __linux__
+    // Requests that wait for a course are served first
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+#endif
+    Logger::info("Listing unscanned courses in the background, " + std::to_string(batch) +
+                 " every " + std::to_string(delay.count()) + " ms");
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(crawl_mutex_);
+            if (crawl_wake_.wait_for(lock, delay, [this]() { return crawl_stopping_; })) {
+                return;
+            }
+        }
+
+        try {
+            // A full rescan can leave courses unscanned again, so the crawler
+            // keeps checking once it has caught up
+            auto current = snapshot();
+            if (current->library.unscannedCourseCount() == 0) {
+                continue;
+            }
 
-    // Create a simple JSON response for search results
-    std::ostringstream json;
-    json << "{\n  \"status\": \"success\",\n  \"data\": {\n    \"query\": \""
-         << JsonResponse::escapeJson(query) << "\",\n    \"results\": [\n";
-
-    for (size_t i = 0; i < results.size(); ++i) {
-        const auto& video = results[i];
-        json << "      {\n";
-        json << "        \"name\": \"" << JsonResponse::escapeJson(video.name) << "\",\n";
-        json << "        \"path\": \"" << JsonResponse::escapeJson(video.relative_path) << "\"\n";
-        json << "      }";
-        if (i < results.size() - 1) json << ",";
-        json << "\n";
-    }
-
-    json << "    ]\n  }\n}";
-    return json.str();
-}
-
-void VideoApi::refreshCache() {
-    if (!cache_valid_) {
-        Logger::debug("Refreshing video library cache");
-        cached_library_ = scanner_->scanLibrary();
-        cache_valid_ = true;
-    }
-}
-
-VideoFile* VideoApi::findVideo(const std::string& year, const std::string& semester,
-                              const std::string& course, const std::string& video) {
-    for (auto& y : cached_library_) {
-        if (y.year == year) {
-            for (auto& s : y.semesters) {
-                if (s.name == semester) {
-                    for (auto& c : s.courses) {
-                        if (c.name == course) {
-                            for (auto& v : c.videos) {
-                                if (v.name == video) {
-                                    return &v;
-                                }
-                            }
-                        }
-                    }
+            std::vector<std::string> paths;
+            const FlatLibrary& library = current->library;
+            for (FlatLibrary::Index c = 0; c < library.courseCount() && paths.size() < batch; ++c) {
+                if (!library.courseScanned(c)) {
+                    paths.push_back(library.coursePath(c));
                 }
             }
+            applyChanges(paths);
+            Logger::debug("Background listing: " + std::to_string(snapshot()->library.unscannedCourseCount()) +
+                          " courses left");
+        } catch (const std::exception& e) {
+            Logger::error("Background course listing failed: " + std::string(e.what()));
         }
     }
-    return nullptr;
 }
 
-} // namespace utec
\ No newline at end of file
+} // namespace utec
@@ -3,31 +3,133 @@
 // src/api/video_api.h
 #pragma once
 #include "utils/types.h"
+#include "api/library_snapshot.h"
+#include "api/change_log.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <memory>
+#include <deque>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 namespace utec {
 
     class DirectoryScanner;
+    class LibraryWatcher;
+    class LibraryPoller;
 
     class VideoApi {
     public:
-        explicit VideoApi(std::shared_ptr<DirectoryScanner> scanner);
+        // compress_responses precompresses the library and course bodies;
+        // a course body is compressed in the background after its first request
+        explicit VideoApi(std::shared_ptr<DirectoryScanner> scanner, size_t change_log_size = 10000,
+                          bool compress_responses = true);
+        ~VideoApi();
 
-        std::string getLibrary();
-        std::string getCourse(const std::string& year, const std::string& semester, const std::string& course);
-        std::string getVideo(const std::string& year, const std::string& semester,
-                            const std::string& course, const std::string& video);
-        std::string searchVideos(const std::string& query);
+        // Serialized and compressed once per library version and shared between requests
+        std::shared_ptr<const EncodedBody> getLibrary();
+        std::shared_ptr<const EncodedBody> getCourse(std::string_view year, std::string_view semester,
+                                                     std::string_view course);
+        std::string getVideo(std::string_view year, std::string_view semester,
+                            std::string_view course, std::string_view video);
+        // Up to limit videos whose name contains query, ignoring ASCII case, best match first
+        std::string searchVideos(std::string_view query, size_t limit);
+        // What changed after generation since, or a resync marker when that is no longer known
+        std::string getChanges(uint64_t since);
+
+        // Validators for the library, changes and search responses: both
+        // change whenever the library is rebuilt
+        std::string getETag();
+        long long getLastModified();
+        // Course and video bodies can also change in between, when a course
+        // is listed again; they are tagged by content and dated by this
+        long long getContentModified();
+
+        // Keeps the library up to date as files are added, removed or replaced
+        bool startWatching(std::chrono::milliseconds coalesce_delay, std::chrono::milliseconds max_delay);
+        void startPolling(std::chrono::seconds interval);  // for changes inotify cannot see
+        // Lazy scans: lists up to batch unscanned courses every delay, on a
+        // low priority thread, until every course has been listed
+        void startCrawling(size_t batch, std::chrono::milliseconds delay);
+        void stopWatching();
+        void applyChanges(const std::vector<std::string>& changed_paths);
+
+        // Serves the library saved by the previous run, if it matches this
+        // root; path is also where every later version of the library is saved
+        bool loadIndex(const std::string& path);
+        // Reconciles a loaded index with the disk on a background thread
+        void verifyIndex();
+
+        // The current library; never blocks once the first scan is done
+        std::shared_ptr<const LibrarySnapshot> snapshot();
+
+        std::shared_ptr<const DirectoryScanner> getScanner() const { return scanner_; }
+        std::shared_ptr<const LibraryWatcher> getWatcher() const { return watcher_; }
+        std::shared_ptr<const LibraryPoller> getPoller() const { return poller_; }
+        ChangeLog::Stats changeLogStats() const { return change_log_.stats(); }
 
     private:
         std::shared_ptr<DirectoryScanner> scanner_;
-        VideoLibrary cached_library_;
-        bool cache_valid_;
+        std::shared_ptr<LibraryWatcher> watcher_;
+        std::shared_ptr<LibraryPoller> poller_;
+        std::mutex update_mutex_;  // writers only: the first scan, splices and publishes
+        std::shared_ptr<const LibrarySnapshot> snapshot_;  // std::atomic_load / std::atomic_store only
+        long long process_epoch_;
+        bool compress_responses_;
+        std::string index_path_;
+        ChangeLog change_log_;  // written under update_mutex_, before the snapshot it describes is published
+        std::thread verify_thread_;
+        std::thread crawl_thread_;
+        std::mutex crawl_mutex_;
+        std::condition_variable crawl_wake_;
+        bool crawl_stopping_ = false;
+        std::thread publish_thread_;
+        std::mutex publish_mutex_;
+        std::condition_variable publish_wake_;
+        bool publish_pending_ = false;
+        bool publish_stopping_ = false;
+        std::chrono::steady_clock::time_point publish_due_;
+
+        // A course body served without its compressed variants, by names so
+        // the variants also reach a later snapshot that carried it over
+        struct Compression {
+            std::string year;
+            std::string semester;
+            std::string course;
+            std::shared_ptr<const EncodedBody> body;
+        };
+        std::thread compress_thread_;
+        std::mutex compress_mutex_;
+        std::condition_variable compress_wake_;
+        std::deque<Compression> compress_queue_;
+        std::unordered_set<const EncodedBody*> compress_queued_;  // bodies in compress_queue_
+        bool compress_stopping_ = false;
 
-        void refreshCache();
-        VideoFile* findVideo(const std::string& year, const std::string& semester,
-                            const std::string& course, const std::string& video);
+        // The current library with the course listed, when it exists; in
+        // lazy mode the first request for a course waits for its listing
+        std::shared_ptr<const LibrarySnapshot> snapshotWithCourse(std::string_view year, std::string_view semester,
+                                                                  std::string_view course);
+        // Makes library, a rescan of current's, the current version with
+        // only the lookups rebuilt, and schedules the publish of the rest;
+        // update_mutex_ held
+        void splice(const std::shared_ptr<const LibrarySnapshot>& current, FlatLibrary library);
+        void crawl(size_t batch, std::chrono::milliseconds delay);
+        void publish(std::shared_ptr<LibrarySnapshot> snapshot);
+        // Spliced versions are published together, a short while after the
+        // first: the library response, search index, generation and saved
+        // index are brought up to date on a background thread
+        void schedulePublish(bool immediately = false);
+        void runPublisher();
+        void publishSplices();
+        void scheduleCompression(const LibrarySnapshot& snapshot, FlatLibrary::Index course,
+                                 std::shared_ptr<const EncodedBody> body);
+        void runCompressor();
+        void saveIndex(const LibrarySnapshot& snapshot);
     };
 
 } // namespace utec
@@ -11,6 +11,33 @@ bool ServerConfig::isValid() const {
     return !root_path.empty() &&
            port > 0 && port <= 65535 &&
            max_file_size > 0 &&
+           stream_buffer_size > 0 &&
+           stream_memory_budget >= stream_buffer_size &&
+           file_cache_entries > 0 &&
+           file_cache_revalidate_interval >= 0 &&
+           block_cache_block_size >= 1024 * 1024 &&
+           block_cache_block_size <= 4 * 1024 * 1024 &&
+           block_cache_size >= block_cache_block_size &&
+           block_cache_shards > 0 &&
+           read_ahead_min_window > 0 &&
+           read_ahead_max_window >= read_ahead_min_window &&
+           read_ahead_sessions > 0 &&
+           read_ahead_session_timeout > 0 &&
+           async_io_threads > 0 &&
+           async_io_queue_depth > 0 && async_io_queue_depth <= 4096 &&
+           async_io_stream_depth > 0 &&
+           bandwidth_burst > 0 &&
+           worker_threads > api_reserve_threads &&
+           max_queued_connections > 0 &&
+           shed_threads > 0 &&
+           retry_after > 0 &&
+           scan_threads > 0 &&
+           cache_refresh_interval >= 0 &&
+           library_watch_delay > 0 &&
+           library_watch_max_delay >= library_watch_delay &&
+           library_crawl_delay > 0 &&
+           library_change_log_size > 0 &&
+           scan_backoff_latency_ms >= 0 &&
            read_timeout > 0 &&
            write_timeout > 0;
 }
@@ -25,6 +52,60 @@ std::string ServerConfig::getValidationError() const {
     if (max_file_size == 0) {
         return "Max file size must be greater than 0";
     }
+    if (stream_buffer_size == 0) {
+        return "Stream buffer size must be greater than 0";
+    }
+    if (stream_memory_budget < stream_buffer_size) {
+        return "Stream memory budget must hold at least one stream buffer";
+    }
+    if (file_cache_entries == 0 || file_cache_revalidate_interval < 0) {
+        return "File cache needs at least one entry and a non-negative revalidate interval";
+    }
+    if (block_cache_block_size < 1024 * 1024 || block_cache_block_size > 4 * 1024 * 1024) {
+        return "Block cache block size must be between 1MB and 4MB";
+    }
+    if (block_cache_size < block_cache_block_size || block_cache_shards == 0) {
+        return "Block cache must hold at least one block and have at least one shard";
+    }
+    if (read_ahead_min_window == 0 || read_ahead_max_window < read_ahead_min_window) {
+        return "Read-ahead max window must be at least the (non-zero) min window";
+    }
+    if (read_ahead_sessions == 0 || read_ahead_session_timeout <= 0) {
+        return "Read-ahead needs at least one session and a positive session timeout";
+    }
+    if (async_io_threads == 0 || async_io_stream_depth == 0) {
+        return "Async I/O needs at least one thread and one read in flight per stream";
+    }
+    if (async_io_queue_depth == 0 || async_io_queue_depth > 4096) {
+        return "Async I/O queue depth must be between 1 and 4096";
+    }
+    if (bandwidth_burst == 0) {
+        return "Bandwidth burst must be greater than 0";
+    }
+    if (worker_threads <= api_reserve_threads) {
+        return "Worker threads must exceed the API reserve";
+    }
+    if (max_queued_connections == 0 || shed_threads == 0 || retry_after <= 0) {
+        return "Admission control needs a connection queue, a shedding thread and a positive Retry-After";
+    }
+    if (scan_threads == 0) {
+        return "Scan threads must be greater than 0";
+    }
+    if (cache_refresh_interval < 0) {
+        return "Cache refresh interval cannot be negative";
+    }
+    if (library_watch_delay <= 0 || library_watch_max_delay < library_watch_delay) {
+        return "Library watch max delay must be at least the (positive) watch delay";
+    }
+    if (library_crawl_delay <= 0) {
+        return "Library crawl delay must be greater than 0";
+    }
+    if (library_change_log_size == 0) {
+        return "Library change log size must be greater than 0";
+    }
+    if (scan_backoff_latency_ms < 0) {
+        return "Scan backoff latency cannot be negative";
+    }
     if (read_timeout <= 0 || write_timeout <= 0) {
         return "Timeouts must be greater than 0";
     }
@@ -6,6 +6,15 @@
 
 namespace utec {
 
+    enum class StreamReadMode {
+        MAPPED,       // write straight from an mmap of the file; a file truncated
+                      // while mapped raises SIGBUS, so only for libraries never
+                      // rewritten in place
+        BLOCK_CACHE,  // read through the shared block cache (network mounts)
+        BUFFERED,     // pread into pooled per-stream buffers
+        ASYNC         // pooled buffers filled ahead of the socket by the async read engine
+    };
+
     struct ServerConfig {
         // Server settings
         std::string root_path;
@@ -17,6 +26,36 @@ namespace utec {
         int write_timeout = 300; // 5 minutes
         size_t max_file_size = 5ULL * 1024 * 1024 * 1024; // 5GB
 
+        // Streaming settings
+        StreamReadMode stream_read_mode = StreamReadMode::BUFFERED;
+        size_t stream_buffer_size = 256 * 1024;             // 256KB per stream read/write
+        size_t stream_memory_budget = 64ULL * 1024 * 1024;  // 64MB across all buffered streams
+        size_t file_cache_entries = 256;                    // open video files kept around
+        int file_cache_revalidate_interval = 2;             // seconds between stat() checks
+        size_t block_cache_size = 256ULL * 1024 * 1024;     // 256MB of shared video blocks
+        size_t block_cache_block_size = 2 * 1024 * 1024;    // 1MB - 4MB
+        size_t block_cache_shards = 16;
+        bool enable_read_ahead = true;                      // per-viewer posix_fadvise hints
+        size_t read_ahead_min_window = 512 * 1024;          // window after open or seek
+        size_t read_ahead_max_window = 16ULL * 1024 * 1024; // window after sustained playback
+        size_t read_ahead_sessions = 1024;
+        int read_ahead_session_timeout = 60;                // seconds before an idle viewer is forgotten
+        bool async_io_prefer_io_uring = true;               // falls back to a pread thread pool
+        size_t async_io_threads = 4;                        // thread pool fallback only
+        size_t async_io_queue_depth = 256;                  // io_uring entries, 1 - 4096
+        size_t async_io_stream_depth = 4;                   // reads kept in flight per stream
+        uint64_t bandwidth_limit = 0;                       // bytes/s shared by all streams, 0 = unlimited
+        uint64_t stream_bandwidth_cap = 0;                  // bytes/s per stream, 0 = fair share only
+        size_t bandwidth_burst = 1024 * 1024;               // token bucket depth
+
+        // Admission control
+        size_t worker_threads = 16;                         // httplib worker pool
+        size_t api_reserve_threads = 2;                     // workers streams can never take
+        size_t max_concurrent_streams = 0;                  // 0 = worker_threads - api_reserve_threads
+        size_t max_queued_connections = 64;                 // beyond this, connections are shed
+        size_t shed_threads = 2;                            // answer shed connections
+        int retry_after = 5;                                // seconds, sent with every 503
+
         // Security settings
         std::vector<std::string> allowed_extensions = {
             "mp4", "avi", "mkv", "mov", "wmv", "flv", "webm", "m4v", "3gp", "mpg", "mpeg"
@@ -30,7 +69,20 @@ namespace utec {
 
         // Cache settings
         bool enable_library_cache = true;
-        int cache_refresh_interval = 300; // 5 minutes
+        size_t scan_threads = 4;          // directory enumeration workers, 1 = serial scan
+        int cache_refresh_interval = 300; // seconds between mtime-pruned rescans, 0 = never
+        bool enable_library_watch = true; // apply inotify changes to the cached library
+        int library_watch_delay = 500;    // ms of quiet before a burst of changes is applied
+        int library_watch_max_delay = 5000; // ms, applied anyway during a long copy
+        std::string library_index_path = "library.index"; // saved library for fast restarts, "" = off
+        bool lazy_library_scan = false;   // scan the directories only; list a course's videos when asked for
+        size_t library_crawl_batch = 32;  // lazy mode: courses listed per background pass, 0 = on demand only
+        int library_crawl_delay = 1000;   // ms between background passes
+        size_t library_change_log_size = 10000; // changes kept for /api/library/changes
+        bool precompress_responses = true; // gzip/br/zstd variants of the API bodies and assets, built once
+        bool scan_idle_io_priority = true; // scans only get the disk when the streams leave it idle
+        size_t scan_ops_per_second = 0;   // directory opens and stats per second, 0 = unlimited
+        int scan_backoff_latency_ms = 50; // scans pause while stream reads average more, 0 = never
 
         // Validation
         bool isValid() const;
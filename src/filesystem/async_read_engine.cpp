@@ -0,0 +1,394 @@
+// src/filesystem/async_read_engine.cpp
+#include "filesystem/async_read_engine.h"
+#include "filesystem/file_handle_cache.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace utec {
+
+namespace {
+
+struct ReadRequest {
+    std::shared_ptr<const FileHandle> file;
+    char* buffer;
+    size_t length;
+    uint64_t offset;
+    AsyncReadEngine::Callback callback;
+};
+
+class ThreadPoolEngine : public AsyncReadEngine {
+public:
+    explicit ThreadPoolEngine(size_t threads) {
+        threads = std::max<size_t>(1, threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { run(); });
+        }
+    }
+
+    ~ThreadPoolEngine() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void submit(std::shared_ptr<const FileHandle> file, char* buffer, size_t length,
+                uint64_t offset, Callback callback) override {
+        submitted_.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(ReadRequest{std::move(file), buffer, length, offset, std::move(callback)});
+        }
+        wake_.notify_one();
+    }
+
+    const char* backend() const override { return "thread_pool"; }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<ReadRequest> queue_;
+    std::vector<std::thread> workers_;
+    bool stopping_ = false;
+
+    void run() {
+        while (true) {
+            ReadRequest request;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                // Queued reads are still completed on shutdown; their callers are waiting
+                if (queue_.empty()) {
+                    return;
+                }
+                request = std::move(queue_.front());
+                queue_.pop_front();
+            }
+
+            long long result = request.file->read(request.buffer, request.length,
+                                                  static_cast<size_t>(request.offset));
+            complete(request.callback, result < 0 ? -static_cast<long long>(errno) : result);
+        }
+    }
+};
+
+#ifdef __linux__
+
+// io_uring without liburing: the rings are mapped by hand and driven with
+// io_uring_enter(). One thread fills the submission queue in batches, a
+// second one reaps completions, so neither waits on the other.
+class IoUringEngine : public AsyncReadEngine {
+public:
+    explicit IoUringEngine(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd_ < 0) {
+            return;
+        }
+
+        // IORING_OP_READ arrived with the same kernel as this feature flag
+        if (!(params.features & IORING_FEAT_RW_CUR_POS) || !mapRings(params)) {
+            unmapRings();
+            ::close(ring_fd_);
+            ring_fd_ = -1;
+            return;
+        }
+
+        entries_ = params.sq_entries;
+        submitter_ = std::thread([this] { submitLoop(); });
+        reaper_ = std::thread([this] { reapLoop(); });
+    }
+
+    ~IoUringEngine() override {
+        if (ring_fd_ < 0) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        submitter_.join();
+        reaper_.join();
+
+        unmapRings();
+        ::close(ring_fd_);
+    }
+
+    bool ready() const { return ring_fd_ >= 0; }
+
+    void submit(std::shared_ptr<const FileHandle> file, char* buffer, size_t length,
+                uint64_t offset, Callback callback) override {
+        submitted_.fetch_add(1, std::memory_order_relaxed);
+        auto request = std::make_unique<ReadRequest>(
+            ReadRequest{std::move(file), buffer, length, offset, std::move(callback)});
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.push_back(request.release());
+        }
+        wake_.notify_all();
+    }
+
+    const char* backend() const override { return "io_uring"; }
+
+private:
+    int ring_fd_ = -1;
+    unsigned entries_ = 0;
+
+    void* sq_ring_ = MAP_FAILED;
+    void* cq_ring_ = MAP_FAILED;
+    size_t sq_ring_size_ = 0;
+    size_t cq_ring_size_ = 0;
+    io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqes_size_ = 0;
+
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_mask_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned* cq_mask_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<ReadRequest*> pending_;
+    size_t in_flight_ = 0;
+    bool stopping_ = false;
+
+    std::thread submitter_;
+    std::thread reaper_;
+
+    bool mapRings(const io_uring_params& params) {
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+
+        sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          ring_fd_, IORING_OFF_SQ_RING);
+        if (sq_ring_ == MAP_FAILED) {
+            return false;
+        }
+
+        if (single_mmap) {
+            cq_ring_ = sq_ring_;
+        } else {
+            cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                              ring_fd_, IORING_OFF_CQ_RING);
+            if (cq_ring_ == MAP_FAILED) {
+                return false;
+            }
+        }
+
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                                                  MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES));
+        if (sqes_ == MAP_FAILED) {
+            return false;
+        }
+
+        char* sq = static_cast<char*>(sq_ring_);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        char* cq = static_cast<char*>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    void unmapRings() {
+        if (sqes_ != MAP_FAILED) {
+            ::munmap(sqes_, sqes_size_);
+        }
+        if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+            ::munmap(cq_ring_, cq_ring_size_);
+        }
+        if (sq_ring_ != MAP_FAILED) {
+            ::munmap(sq_ring_, sq_ring_size_);
+        }
+    }
+
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+        return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete,
+                                          flags, nullptr, 0));
+    }
+
+    // Only the submitter thread writes the submission queue
+    void queueEntry(uint8_t opcode, const ReadRequest* request) {
+        unsigned tail = *sq_tail_;
+        unsigned index = tail & *sq_mask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = opcode;
+        if (request) {
+            sqe->fd = request->file->descriptor();
+            sqe->addr = reinterpret_cast<uint64_t>(request->buffer);
+            sqe->len = static_cast<uint32_t>(request->length);
+            sqe->off = request->offset;
+        } else {
+            sqe->fd = -1;
+        }
+        sqe->user_data = reinterpret_cast<uint64_t>(request);
+        sq_array_[index] = index;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    void submitLoop() {
+        std::vector<ReadRequest*> batch;
+        unsigned unsubmitted = 0;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this, unsubmitted] {
+                    return unsubmitted > 0 || (stopping_ && pending_.empty()) ||
+                           (!pending_.empty() && in_flight_ < entries_);
+                });
+                if (unsubmitted == 0 && stopping_ && pending_.empty()) {
+                    break;
+                }
+
+                size_t room = entries_ - std::min<size_t>(entries_, in_flight_ + unsubmitted);
+                size_t count = std::min(room, pending_.size());
+                batch.assign(pending_.begin(), pending_.begin() + count);
+                pending_.erase(pending_.begin(), pending_.begin() + count);
+                in_flight_ += count;
+            }
+
+            for (ReadRequest* request : batch) {
+                queueEntry(IORING_OP_READ, request);
+            }
+            unsubmitted += static_cast<unsigned>(batch.size());
+
+            // One system call hands the whole batch to the kernel
+            int result = enter(unsubmitted, 0, 0);
+            if (result >= 0) {
+                unsubmitted -= static_cast<unsigned>(result);
+                batches_.fetch_add(1, std::memory_order_relaxed);
+            } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                Logger::error("io_uring_enter failed: " + std::string(std::strerror(errno)));
+            }
+            if (unsubmitted > 0) {
+                std::this_thread::yield();
+            }
+        }
+
+        // A no-op with empty user data tells the reaper nothing else is coming
+        queueEntry(IORING_OP_NOP, nullptr);
+        while (enter(1, 0, 0) < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY)) {
+            std::this_thread::yield();
+        }
+    }
+
+    void reapLoop() {
+        bool stop_seen = false;
+        std::vector<std::pair<ReadRequest*, int>> completions;
+
+        while (true) {
+            unsigned head = *cq_head_;
+            unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            if (head == tail) {
+                if (stop_seen) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (in_flight_ == 0) {
+                        break;
+                    }
+                }
+                enter(0, 1, IORING_ENTER_GETEVENTS);
+                continue;
+            }
+
+            completions.clear();
+            for (; head != tail; ++head) {
+                const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+                auto* request = reinterpret_cast<ReadRequest*>(cqe.user_data);
+                if (request) {
+                    completions.emplace_back(request, cqe.res);
+                } else {
+                    stop_seen = true;
+                }
+            }
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                in_flight_ -= completions.size();
+            }
+            wake_.notify_all();
+
+            for (auto& [request, result] : completions) {
+                complete(request->callback, result);
+                delete request;
+            }
+        }
+    }
+};
+
+#endif
+
+} // namespace
+
+std::unique_ptr<AsyncReadEngine> AsyncReadEngine::create(bool prefer_io_uring, size_t threads,
+                                                         size_t queue_depth) {
+#ifdef __linux__
+    if (prefer_io_uring) {
+        auto engine = std::make_unique<IoUringEngine>(static_cast<unsigned>(queue_depth));
+        if (engine->ready()) {
+            Logger::info("Async reads use io_uring");
+            return engine;
+        }
+        Logger::warning("io_uring unavailable, async reads use a thread pool");
+    }
+#else
+    (void)prefer_io_uring;
+    (void)queue_depth;
+#endif
+    return std::make_unique<ThreadPoolEngine>(threads);
+}
+
+AsyncReadEngine::Stats AsyncReadEngine::stats() const {
+    Stats stats;
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    stats.completed = completed_.load(std::memory_order_relaxed);
+    stats.failed = failed_.load(std::memory_order_relaxed);
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.in_flight = stats.submitted - std::min(stats.submitted, stats.completed);
+    return stats;
+}
+
+void AsyncReadEngine::complete(const Callback& callback, long long result) {
+    if (result < 0) {
+        failed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    completed_.fetch_add(1, std::memory_order_relaxed);
+    callback(result);
+}
+
+} // namespace utec
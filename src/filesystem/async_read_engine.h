@@ -0,0 +1,52 @@
+// src/filesystem/async_read_engine.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace utec {
+
+    class FileHandle;
+
+    // Positional reads completed on a small set of engine threads instead of
+    // the HTTP worker that asked for them. On Linux the engine drives an
+    // io_uring directly through its system calls; where io_uring is missing
+    // or refused, a pool of threads calling pread() takes its place.
+    class AsyncReadEngine {
+    public:
+        // Receives the byte count read, or -errno
+        using Callback = std::function<void(long long result)>;
+
+        struct Stats {
+            uint64_t submitted = 0;
+            uint64_t completed = 0;
+            uint64_t failed = 0;
+            uint64_t batches = 0;
+            uint64_t in_flight = 0;
+        };
+
+        static std::unique_ptr<AsyncReadEngine> create(bool prefer_io_uring, size_t threads,
+                                                       size_t queue_depth);
+
+        virtual ~AsyncReadEngine() = default;
+
+        // The buffer must stay valid until the callback has run; the engine
+        // keeps the file open until then
+        virtual void submit(std::shared_ptr<const FileHandle> file, char* buffer, size_t length,
+                            uint64_t offset, Callback callback) = 0;
+        virtual const char* backend() const = 0;
+
+        Stats stats() const;
+
+    protected:
+        std::atomic<uint64_t> submitted_{0};
+        std::atomic<uint64_t> completed_{0};
+        std::atomic<uint64_t> failed_{0};
+        std::atomic<uint64_t> batches_{0};
+
+        void complete(const Callback& callback, long long result);
+    };
+
+} // namespace utec
@@ -0,0 +1,133 @@
+// src/filesystem/block_cache.cpp
+#include "filesystem/block_cache.h"
+#include "filesystem/file_handle_cache.h"
+#include <algorithm>
+#include <chrono>
+
+namespace utec {
+
+size_t BlockCache::KeyHash::operator()(const Key& key) const {
+    // 64-bit mix of the four fields; shards and buckets both use the result
+    uint64_t h = key.inode * 0x9E3779B97F4A7C15ULL;
+    h ^= key.index + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    h ^= key.device + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    h ^= static_cast<uint64_t>(key.mtime) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    return static_cast<size_t>(h ^ (h >> 32));
+}
+
+BlockCache::BlockCache(size_t capacity_bytes, size_t block_size, size_t shard_count)
+    : block_size_(block_size) {
+    shard_count = std::max<size_t>(1, shard_count);
+    shard_capacity_ = std::max(block_size_, capacity_bytes / shard_count);
+
+    shards_.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+std::shared_ptr<const BlockCache::Block> BlockCache::get(const FileHandle& file, uint64_t block_index) {
+    // mtime is part of the key, so a recording rewritten in place never serves stale blocks
+    Key key{file.device(), file.inode(), file.mtime(), block_index};
+    Shard& shard = *shards_[KeyHash{}(key) % shards_.size()];
+
+    std::promise<std::shared_ptr<const Block>> promise;
+    BlockFuture pending;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru_position);
+            pending = it->second.block;
+            hits_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            shard.lru.push_front(key);
+            shard.entries.emplace(key, Entry{promise.get_future().share(), shard.lru.begin()});
+            shard.bytes += block_size_;
+            evict(shard);
+        }
+    }
+
+    if (pending.valid()) {
+        return pending.get();
+    }
+
+    std::shared_ptr<const Block> block;
+    try {
+        block = readBlock(file, block_index);
+    } catch (const std::exception&) {
+        block = nullptr;
+    }
+    promise.set_value(block);
+
+    if (!block) {
+        read_errors_.fetch_add(1, std::memory_order_relaxed);
+
+        // Drop the failed entry so the next request retries the read
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end() &&
+            it->second.block.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+            !it->second.block.get()) {
+            shard.lru.erase(it->second.lru_position);
+            shard.entries.erase(it);
+            shard.bytes -= block_size_;
+        }
+    }
+
+    return block;
+}
+
+BlockCache::Stats BlockCache::stats() const {
+    Stats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.evictions = evictions_.load(std::memory_order_relaxed);
+    stats.read_errors = read_errors_.load(std::memory_order_relaxed);
+    stats.capacity_bytes = shard_capacity_ * shards_.size();
+
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        stats.cached_blocks += shard->entries.size();
+        stats.cached_bytes += shard->bytes;
+    }
+    return stats;
+}
+
+std::shared_ptr<const BlockCache::Block> BlockCache::readBlock(const FileHandle& file,
+                                                                uint64_t block_index) const {
+    uint64_t offset = block_index * block_size_;
+    if (offset >= file.size()) {
+        return nullptr;
+    }
+
+    auto block = std::make_shared<Block>();
+    block->size = static_cast<size_t>(std::min<uint64_t>(block_size_, file.size() - offset));
+    block->data.reset(new char[block->size]);
+
+    size_t filled = 0;
+    while (filled < block->size) {
+        long long bytes_read = file.read(block->data.get() + filled, block->size - filled,
+                                         static_cast<size_t>(offset + filled));
+        if (bytes_read <= 0) {
+            return nullptr;
+        }
+        filled += static_cast<size_t>(bytes_read);
+    }
+
+    return block;
+}
+
+void BlockCache::evict(Shard& shard) {
+    // Blocks still referenced by a stream stay alive until that stream moves on;
+    // the budget bounds what the cache itself keeps
+    while (shard.bytes > shard_capacity_ && shard.lru.size() > 1) {
+        shard.entries.erase(shard.lru.back());
+        shard.lru.pop_back();
+        shard.bytes -= block_size_;
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace utec
@@ -0,0 +1,90 @@
+// src/filesystem/block_cache.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace utec {
+
+    class FileHandle;
+
+    // Shared cache of aligned file blocks. Viewers of the same lecture read the
+    // same blocks, so one disk read serves all of them. Lookups are spread over
+    // independent shards, each with its own lock, LRU list and share of the budget.
+    class BlockCache {
+    public:
+        struct Block {
+            std::unique_ptr<char[]> data;
+            size_t size = 0;
+        };
+
+        struct Stats {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+            uint64_t read_errors = 0;
+            uint64_t cached_blocks = 0;
+            uint64_t cached_bytes = 0;
+            uint64_t capacity_bytes = 0;
+        };
+
+        BlockCache(size_t capacity_bytes, size_t block_size, size_t shard_count);
+
+        // Returns the block containing block_index * blockSize(), reading it on a miss.
+        // Concurrent misses for the same block wait for a single read.
+        std::shared_ptr<const Block> get(const FileHandle& file, uint64_t block_index);
+
+        size_t blockSize() const { return block_size_; }
+        Stats stats() const;
+
+    private:
+        struct Key {
+            uint64_t device;
+            uint64_t inode;
+            int64_t mtime;
+            uint64_t index;
+
+            bool operator==(const Key& other) const {
+                return index == other.index && inode == other.inode &&
+                       device == other.device && mtime == other.mtime;
+            }
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key& key) const;
+        };
+
+        using BlockFuture = std::shared_future<std::shared_ptr<const Block>>;
+
+        struct Entry {
+            BlockFuture block;
+            std::list<Key>::iterator lru_position;
+        };
+
+        struct Shard {
+            std::mutex mutex;
+            std::unordered_map<Key, Entry, KeyHash> entries;
+            std::list<Key> lru;
+            size_t bytes = 0;
+        };
+
+        size_t block_size_;
+        size_t shard_capacity_;
+        std::vector<std::unique_ptr<Shard>> shards_;
+
+        std::atomic<uint64_t> hits_{0};
+        std::atomic<uint64_t> misses_{0};
+        std::atomic<uint64_t> evictions_{0};
+        std::atomic<uint64_t> read_errors_{0};
+
+        std::shared_ptr<const Block> readBlock(const FileHandle& file, uint64_t block_index) const;
+        void evict(Shard& shard);
+    };
+
+} // namespace utec
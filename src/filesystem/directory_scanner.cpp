@@ -1,21 +1,247 @@
 // src/filesystem/directory_scanner.cpp
 #include "filesystem/directory_scanner.h"
 #include "filesystem/file_utils.h"
+#include "filesystem/scan_throttle.h"
 #include "utils/string_utils.h"
 #include "utils/logger.h"
 #include <filesystem>
 #include <algorithm>  // Added missing include
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <set>
+#include <tuple>
+#include <thread>
+#include <unordered_map>
 
 namespace fs = std::filesystem;
 
 namespace utec {
 
-DirectoryScanner::DirectoryScanner(const std::string& root_path)
-    : root_path_(FileUtils::getAbsolutePath(root_path)) {
-    Logger::info("Initializing directory scanner for: " + root_path_);
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// A directory modified this close to its listing may change again within the
+// same timestamp tick, so its mtime cannot prove the listing is current
+constexpr auto RACY_WINDOW = std::chrono::seconds(2);
+
+struct ScanCounters {
+    std::atomic<uint64_t> directories{0};
+    std::atomic<uint64_t> busy_time_us{0};
+    DirectorySyscalls syscalls;
+};
+
+bool isYearName(const std::string& name) {
+    // A year looks like 4 digits
+    return name.length() == 4 && std::all_of(name.begin(), name.end(), ::isdigit);
+}
+
+bool isSemesterName(const std::string& name) {
+    return name.find("Semester_") == 0;
+}
+
+std::vector<std::string> listSubdirectories(const std::string& path,
+                                            const std::function<bool(const std::string&)>& accept,
+                                            DirectorySyscalls& syscalls) {
+    std::vector<std::string> directories;
+    for (auto& entry : FileUtils::readDirectory(path, nullptr, &syscalls)) {
+        if (entry.type == DirectoryEntry::Type::DIRECTORY && accept(entry.name)) {
+            directories.push_back(std::move(entry.name));
+        }
+    }
+    return directories;
+}
+
+// Runs task(0) .. task(count - 1) on up to `threads` threads. Each task only
+// writes its own result slot, so the output order never depends on timing.
+void parallelFor(size_t count, size_t threads, ScanCounters& counters,
+                 const std::function<void(size_t)>& task) {
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        IdleIoPriority io_priority(counters.syscalls.throttle);
+        for (size_t index = next++; index < count; index = next++) {
+            auto start = Clock::now();
+            try {
+                task(index);
+            } catch (const std::exception& e) {
+                Logger::warning("Scan task failed: " + std::string(e.what()));
+            }
+            counters.busy_time_us += static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+        }
+    };
+
+    std::vector<std::thread> pool;
+    size_t extra = std::min(threads, count);
+    for (size_t i = 1; i < extra; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+// Rescanned entries by name, at each level; a scan that came back empty
+// removes its entry
+template <typename T>
+using ByName = std::map<std::string, T, std::less<>>;
+
+template <typename T>
+const T* findScan(const ByName<T>& scans, std::string_view name) {
+    auto it = scans.find(name);
+    return it != scans.end() ? &it->second : nullptr;
+}
+
+// Listings are sorted by name, so a library's entries are found by binary search
+template <typename NameFn>
+FlatLibrary::Index findName(FlatLibrary::Index begin, FlatLibrary::Index end, NameFn name,
+                            std::string_view wanted) {
+    while (begin < end) {
+        FlatLibrary::Index middle = begin + (end - begin) / 2;
+        if (name(middle) < wanted) {
+            begin = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+    return begin;
+}
+
+// Walks the entries [begin, end) and the replacements in name order:
+// keep(i) for an entry without a replacement, and replace(value) in place
+// of the entry with its name, or where a new entry sorts
+template <typename T, typename NameFn, typename KeepFn, typename ReplaceFn>
+void mergeByName(FlatLibrary::Index begin, FlatLibrary::Index end, NameFn name, const ByName<T>* replacements,
+                 KeepFn keep, ReplaceFn replace) {
+    FlatLibrary::Index i = begin;
+    if (replacements) {
+        for (const auto& [replaced, value] : *replacements) {
+            for (; i < end && name(i) < replaced; ++i) {
+                keep(i);
+            }
+            if (i < end && name(i) == replaced) {
+                ++i;
+            }
+            replace(value);
+        }
+    }
+    for (; i < end; ++i) {
+        keep(i);
+    }
+}
+
+// Appends to a library under construction. A year or semester is added
+// with its first course, so empty ones are left out as with a scan
+class LibraryAppender {
+public:
+    explicit LibraryAppender(FlatLibrary& library) : library_(library) {}
+
+    void beginYear(std::string_view name) {
+        year_ = name;
+        year_open_ = false;
+        semester_open_ = false;
+    }
+
+    void beginSemester(std::string_view name) {
+        semester_ = name;
+        semester_open_ = false;
+    }
+
+    void copyCourses(const FlatLibrary& base, FlatLibrary::Index begin, FlatLibrary::Index end) {
+        if (begin < end) {
+            open();
+            library_.copyCourses(base, begin, end);
+        }
+    }
+
+    void addYear(const AcademicYear& year) {
+        beginYear(year.year);
+        for (const auto& semester : year.semesters) {
+            addSemester(semester);
+        }
+    }
+
+    void addSemester(const Semester& semester) {
+        beginSemester(semester.name);
+        for (const auto& course : semester.courses) {
+            addCourse(course);
+        }
+    }
+
+    void addCourse(const Course& course) {
+        if (course.videos.empty() && course.scanned) {
+            return;
+        }
+        open();
+        library_.addCourse(StringUtils::getBaseName(course.path), course.mtime, course.scanned);
+        for (const auto& video : course.videos) {
+            library_.addVideo(video.name, video.size);
+        }
+    }
+
+private:
+    FlatLibrary& library_;
+    std::string_view year_;
+    std::string_view semester_;
+    bool year_open_ = false;
+    bool semester_open_ = false;
+
+    void open() {
+        if (!year_open_) {
+            library_.addYear(year_);
+            year_open_ = true;
+        }
+        if (!semester_open_) {
+            library_.addSemester(semester_);
+            semester_open_ = true;
+        }
+    }
+};
+
+// Counts a full scan as running for the throttle's progress metrics
+class ScanProgress {
+public:
+    explicit ScanProgress(ScanThrottle* throttle) : throttle_(throttle) {
+        if (throttle_) throttle_->beginScan();
+    }
+    ~ScanProgress() {
+        if (throttle_) throttle_->endScan();
+    }
+
+    ScanProgress(const ScanProgress&) = delete;
+    ScanProgress& operator=(const ScanProgress&) = delete;
+
+private:
+    ScanThrottle* throttle_;
+};
+
+void paceStat(ScanThrottle* throttle) {
+    if (throttle) {
+        throttle->acquire(ScanThrottle::Op::STAT);
+    }
+}
+
+Course unscannedCourse(const std::string& course_path) {
+    Course course;
+    course.path = course_path;
+    course.name = StringUtils::replaceAll(StringUtils::getBaseName(course_path), "_", " ");
+    course.scanned = false;
+    return course;
 }
 
-VideoLibrary DirectoryScanner::scanLibrary() {
+} // namespace
+
+DirectoryScanner::DirectoryScanner(const std::string& root_path, size_t scan_threads, bool lazy)
+    : root_path_(FileUtils::getAbsolutePath(root_path)), scan_threads_(std::max<size_t>(1, scan_threads)),
+      lazy_(lazy) {
+    Logger::info("Initializing directory scanner for: " + root_path_ + (lazy_ ? " (lazy)" : ""));
+}
+
+VideoLibrary DirectoryScanner::scanLibrary(bool paced) {
     VideoLibrary library;
 
     if (!FileUtils::exists(root_path_) || !FileUtils::isDirectory(root_path_)) {
@@ -24,27 +250,308 @@ VideoLibrary DirectoryScanner::scanLibrary() {
     }
 
     Logger::info("Scanning video library...");
+    auto scan_start = Clock::now();
+    ScanThrottle* throttle = paced ? throttle_.get() : nullptr;
+    ScanCounters counters;
+    counters.syscalls.throttle = throttle;
+    IdleIoPriority io_priority(throttle);
+    ScanProgress progress(throttle);
+
+    // Each level is listed in parallel before descending, so even a tree with
+    // a single year keeps every worker busy once the courses are reached
+    std::vector<std::string> years = listSubdirectories(root_path_, isYearName, counters.syscalls);
+    ++counters.directories;
+
+    std::vector<std::vector<std::string>> semesters(years.size());
+    parallelFor(years.size(), scan_threads_, counters, [&](size_t y) {
+        Logger::debug("Scanning year: " + years[y]);
+        semesters[y] = listSubdirectories(root_path_ + "/" + years[y], isSemesterName, counters.syscalls);
+        ++counters.directories;
+    });
+
+    struct SemesterRef { size_t year; size_t semester; std::string path; };
+    std::vector<SemesterRef> semester_refs;
+    for (size_t y = 0; y < years.size(); ++y) {
+        for (size_t s = 0; s < semesters[y].size(); ++s) {
+            semester_refs.push_back({y, s, root_path_ + "/" + years[y] + "/" + semesters[y][s]});
+        }
+    }
 
-    auto entries = FileUtils::listDirectory(root_path_);
-    for (const auto& entry : entries) {
-        std::string year_path = root_path_ + "/" + entry;
-
-        if (FileUtils::isDirectory(year_path)) {
-            // Check if it looks like a year (4 digits)
-            if (entry.length() == 4 && std::all_of(entry.begin(), entry.end(), ::isdigit)) {
-                Logger::debug("Scanning year: " + entry);
-                AcademicYear year = scanYear(year_path);
-                if (!year.semesters.empty()) {
-                    library.push_back(year);
-                }
+    std::vector<std::vector<std::string>> course_names(semester_refs.size());
+    parallelFor(semester_refs.size(), scan_threads_, counters, [&](size_t i) {
+        Logger::debug("Scanning semester: " + semester_refs[i].path);
+        course_names[i] = listSubdirectories(semester_refs[i].path,
+                                             [](const std::string&) { return true; }, counters.syscalls);
+        ++counters.directories;
+    });
+
+    struct CourseRef { size_t semester_ref; std::string path; };
+    std::vector<CourseRef> course_refs;
+    for (size_t i = 0; i < semester_refs.size(); ++i) {
+        for (const auto& name : course_names[i]) {
+            course_refs.push_back({i, semester_refs[i].path + "/" + name});
+        }
+    }
+
+    std::vector<Course> courses(course_refs.size());
+    if (lazy_) {
+        // Only the skeleton; each course is listed when first asked for
+        for (size_t i = 0; i < course_refs.size(); ++i) {
+            courses[i] = unscannedCourse(course_refs[i].path);
+        }
+    } else {
+        parallelFor(course_refs.size(), scan_threads_, counters, [&](size_t i) {
+            courses[i] = scanCourse(course_refs[i].path, &counters.syscalls);
+            ++counters.directories;
+        });
+    }
+
+    // Merge in listing order; empty courses, semesters and years are dropped as before
+    std::vector<std::vector<Course>> semester_courses(semester_refs.size());
+    for (size_t i = 0; i < course_refs.size(); ++i) {
+        if (!courses[i].videos.empty() || !courses[i].scanned) {
+            semester_courses[course_refs[i].semester_ref].push_back(std::move(courses[i]));
+        }
+    }
+
+    size_t next_ref = 0;
+    for (size_t y = 0; y < years.size(); ++y) {
+        AcademicYear year;
+        year.year = years[y];
+        year.path = root_path_ + "/" + years[y];
+
+        for (; next_ref < semester_refs.size() && semester_refs[next_ref].year == y; ++next_ref) {
+            if (semester_courses[next_ref].empty()) {
+                continue;
             }
+            Semester semester;
+            semester.path = semester_refs[next_ref].path;
+            semester.name = semesters[y][semester_refs[next_ref].semester];
+            semester.courses = std::move(semester_courses[next_ref]);
+            year.semesters.push_back(std::move(semester));
+        }
+
+        if (!year.semesters.empty()) {
+            library.push_back(std::move(year));
+        }
+    }
+
+    ScanStats stats;
+    stats.threads = scan_threads_;
+    stats.directories = counters.directories;
+    stats.wall_time_us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - scan_start).count());
+    stats.busy_time_us = counters.busy_time_us;
+    stats.directory_opens = counters.syscalls.opens;
+    stats.directory_reads = counters.syscalls.reads;
+    stats.stat_calls = counters.syscalls.stats;
+    stats.entries = counters.syscalls.entries;
+    stats.typed_entries = counters.syscalls.typed_entries;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        last_stats_ = stats;
+    }
+
+    char speedup[16];
+    std::snprintf(speedup, sizeof(speedup), "%.2f", stats.parallelism());
+    Logger::info("Library scan complete. Found " + std::to_string(library.size()) + " years in " +
+                 std::to_string(stats.wall_time_us / 1000) + " ms (" +
+                 std::to_string(stats.directories) + " directories, " +
+                 std::to_string(stats.threads) + " threads, " + speedup + "x effective parallelism)");
+    Logger::info("Scan system calls: " + std::to_string(stats.directory_opens) + " opens, " +
+                 std::to_string(stats.directory_reads) + " getdents, " +
+                 std::to_string(stats.stat_calls) + " stats for " + std::to_string(stats.entries) +
+                 " entries (" + std::to_string(stats.typed_entries) + " typed by the listing)");
+    return library;
+}
+
+void DirectoryScanner::setThrottle(std::shared_ptr<ScanThrottle> throttle) {
+    throttle_ = std::move(throttle);
+}
+
+DirectoryScanner::ScanStats DirectoryScanner::lastScanStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return last_stats_;
+}
+
+FlatLibrary DirectoryScanner::rescan(const FlatLibrary& current, const std::vector<std::string>& changed_paths,
+                                     bool paced) {
+    using Index = FlatLibrary::Index;
+    using SemesterKey = std::pair<std::string, std::string>;
+    using CourseKey = std::tuple<std::string, std::string, std::string>;
+
+    // Reduce every changed path to the year, semester or course containing it
+    std::set<std::string> years;
+    std::set<SemesterKey> semesters;
+    std::set<CourseKey> courses;
+    for (const auto& path : changed_paths) {
+        if (path.compare(0, root_path_.length(), root_path_) != 0 ||
+            (path.length() > root_path_.length() && path[root_path_.length()] != '/')) {
+            continue;
+        }
+
+        auto parts = StringUtils::split(path.substr(root_path_.length()), '/');
+        if (parts.empty()) {
+            Logger::debug("Library root changed, rescanning everything");
+            return FlatLibrary(root_path_, scanLibrary(paced));
+        }
+        if (parts.size() == 1) {
+            years.insert(parts[0]);
+        } else if (parts.size() == 2) {
+            semesters.insert({parts[0], parts[1]});
+        } else {
+            courses.insert(CourseKey{parts[0], parts[1], parts[2]});
+        }
+    }
+
+    auto yearName = [&](Index y) { return current.yearName(y); };
+    auto semesterName = [&](Index s) { return current.semesterName(s); };
+    auto courseDirectory = [&](Index c) { return current.courseDirectory(c); };
+    auto findYear = [&](const std::string& year) {
+        Index y = findName(0, static_cast<Index>(current.yearCount()), yearName, year);
+        return y < current.yearCount() && current.yearName(y) == year ? y : FlatLibrary::npos;
+    };
+    auto hasSemester = [&](const std::string& year, const std::string& semester) {
+        Index y = findYear(year);
+        if (y == FlatLibrary::npos) {
+            return false;
+        }
+        Index s = findName(current.semesterBegin(y), current.semesterEnd(y), semesterName, semester);
+        return s < current.semesterEnd(y) && current.semesterName(s) == semester;
+    };
+
+    // Empty courses, semesters and years are not in the library; a change
+    // below one of them is picked up by scanning it as a whole
+    for (const auto& course : courses) {
+        if (!hasSemester(std::get<0>(course), std::get<1>(course))) {
+            semesters.insert({std::get<0>(course), std::get<1>(course)});
+        }
+    }
+    for (const auto& semester : semesters) {
+        if (findYear(semester.first) == FlatLibrary::npos) {
+            years.insert(semester.first);
+        }
+    }
+
+    DirectorySyscalls syscalls;
+    syscalls.throttle = paced ? throttle_.get() : nullptr;
+    IdleIoPriority io_priority(syscalls.throttle);
+
+    ByName<AcademicYear> year_scans;
+    for (const auto& name : years) {
+        if (isYearName(name)) {
+            year_scans.emplace(name, scanYear(name, syscalls));
+        }
+    }
+
+    ByName<ByName<Semester>> semester_scans;
+    for (const auto& [year, semester] : semesters) {
+        if (years.count(year) || !isSemesterName(semester)) {
+            continue;
+        }
+        semester_scans[year].emplace(semester, scanSemester(year, semester, syscalls));
+    }
+
+    ByName<ByName<ByName<Course>>> course_scans;
+    for (const auto& [year, semester, course] : courses) {
+        if (years.count(year) || semesters.count({year, semester})) {
+            continue;
         }
+        course_scans[year][semester].emplace(
+            course, scanCourse(root_path_ + "/" + year + "/" + semester + "/" + course, &syscalls));
     }
 
-    Logger::info("Library scan complete. Found " + std::to_string(library.size()) + " years");
+    // Everything else is copied from current, a semester at a time where
+    // none of its courses changed
+    FlatLibrary library(root_path_);
+    library.reuseNames(current);
+    LibraryAppender append(library);
+    mergeByName(0, static_cast<Index>(current.yearCount()), yearName, &year_scans,
+        [&](Index y) {
+            append.beginYear(current.yearName(y));
+            const auto* year_semesters = findScan(semester_scans, current.yearName(y));
+            const auto* year_courses = findScan(course_scans, current.yearName(y));
+            mergeByName(current.semesterBegin(y), current.semesterEnd(y), semesterName, year_semesters,
+                [&](Index s) {
+                    append.beginSemester(current.semesterName(s));
+                    const auto* semester_courses =
+                        year_courses ? findScan(*year_courses, current.semesterName(s)) : nullptr;
+                    if (!semester_courses) {
+                        append.copyCourses(current, current.courseBegin(s), current.courseEnd(s));
+                        return;
+                    }
+                    mergeByName(current.courseBegin(s), current.courseEnd(s), courseDirectory, semester_courses,
+                        [&](Index c) { append.copyCourses(current, c, c + 1); },
+                        [&](const Course& course) { append.addCourse(course); });
+                },
+                [&](const Semester& semester) { append.addSemester(semester); });
+        },
+        [&](const AcademicYear& year) { append.addYear(year); });
+    library.finish();
+
+    Logger::debug("Rescanned " + std::to_string(years.size()) + " years, " +
+                  std::to_string(semesters.size()) + " semesters and " +
+                  std::to_string(courses.size()) + " courses (" +
+                  std::to_string(syscalls.opens.load()) + " directory opens)");
     return library;
 }
 
+std::vector<std::string> DirectoryScanner::findChanges(const FlatLibrary& library) {
+    struct KnownCourse { int64_t mtime; bool scanned; bool seen; };
+    std::unordered_map<std::string, KnownCourse> known;
+    known.reserve(library.courseCount());
+    for (FlatLibrary::Index c = 0; c < library.courseCount(); ++c) {
+        known.emplace(library.coursePath(c), KnownCourse{library.courseMtime(c), library.courseScanned(c), false});
+    }
+
+    // Years and semesters are few and always listed; courses are only
+    // stat()ed, and listed again by rescan() when their mtime moved
+    std::vector<std::string> changed;
+    DirectorySyscalls syscalls;
+    syscalls.throttle = throttle_.get();
+    IdleIoPriority io_priority(throttle_.get());
+    size_t seen = 0;
+    for (const auto& year : listSubdirectories(root_path_, isYearName, syscalls)) {
+        std::string year_path = root_path_ + "/" + year;
+        for (const auto& semester : listSubdirectories(year_path, isSemesterName, syscalls)) {
+            std::string semester_path = year_path + "/" + semester;
+            auto courses = listSubdirectories(semester_path, [](const std::string&) { return true; }, syscalls);
+            for (const auto& course : courses) {
+                std::string course_path = semester_path + "/" + course;
+                auto it = known.find(course_path);
+                if (it == known.end()) {
+                    // New, or still without videos
+                    changed.push_back(course_path);
+                    continue;
+                }
+                ++seen;
+                it->second.seen = true;
+                if (!it->second.scanned) {
+                    continue;
+                }
+                paceStat(syscalls.throttle);
+                ++syscalls.stats;
+                if (it->second.mtime == 0 || FileUtils::getModificationTime(course_path) != it->second.mtime) {
+                    changed.push_back(course_path);
+                }
+            }
+        }
+    }
+
+    if (seen < known.size()) {
+        for (const auto& entry : known) {
+            if (!entry.second.seen) {
+                changed.push_back(entry.first);
+            }
+        }
+    }
+
+    Logger::debug("Library check: " + std::to_string(known.size()) + " courses, " +
+                  std::to_string(changed.size()) + " changed (" + std::to_string(syscalls.opens.load()) +
+                  " directory opens, " + std::to_string(syscalls.stats.load()) + " stats)");
+    return changed;
+}
+
 bool DirectoryScanner::isValidStructure() const {
     if (!FileUtils::exists(root_path_) || !FileUtils::isDirectory(root_path_)) {
         return false;
@@ -64,52 +571,38 @@ bool DirectoryScanner::isValidStructure() const {
     return false;
 }
 
-AcademicYear DirectoryScanner::scanYear(const std::string& year_path) {
+AcademicYear DirectoryScanner::scanYear(const std::string& year_name, DirectorySyscalls& syscalls) {
     AcademicYear year;
-    year.path = year_path;
-    year.year = StringUtils::getBaseName(year_path);
+    year.year = year_name;
+    year.path = root_path_ + "/" + year_name;
 
-    auto entries = FileUtils::listDirectory(year_path);
-    for (const auto& entry : entries) {
-        std::string semester_path = year_path + "/" + entry;
-
-        if (FileUtils::isDirectory(semester_path)) {
-            // Check if it looks like a semester (starts with "Semester_")
-            if (entry.find("Semester_") == 0) {
-                Logger::debug("Scanning semester: " + entry);
-                Semester semester = scanSemester(semester_path);
-                if (!semester.courses.empty()) {
-                    year.semesters.push_back(semester);
-                }
-            }
+    for (const auto& name : listSubdirectories(year.path, isSemesterName, syscalls)) {
+        Semester semester = scanSemester(year_name, name, syscalls);
+        if (!semester.courses.empty()) {
+            year.semesters.push_back(std::move(semester));
         }
     }
-
     return year;
 }
 
-Semester DirectoryScanner::scanSemester(const std::string& semester_path) {
+Semester DirectoryScanner::scanSemester(const std::string& year, const std::string& semester_name,
+                                        DirectorySyscalls& syscalls) {
     Semester semester;
-    semester.path = semester_path;
-    semester.name = StringUtils::getBaseName(semester_path);
-
-    auto entries = FileUtils::listDirectory(semester_path);
-    for (const auto& entry : entries) {
-        std::string course_path = semester_path + "/" + entry;
-
-        if (FileUtils::isDirectory(course_path)) {
-            Logger::debug("Scanning course: " + entry);
-            Course course = scanCourse(course_path);
-            if (!course.videos.empty()) {
-                semester.courses.push_back(course);
-            }
+    semester.name = semester_name;
+    semester.path = root_path_ + "/" + year + "/" + semester_name;
+
+    auto names = listSubdirectories(semester.path, [](const std::string&) { return true; }, syscalls);
+    for (const auto& name : names) {
+        Course course = lazy_ ? unscannedCourse(semester.path + "/" + name)
+                              : scanCourse(semester.path + "/" + name, &syscalls);
+        if (!course.videos.empty() || !course.scanned) {
+            semester.courses.push_back(std::move(course));
         }
     }
-
     return semester;
 }
 
-Course DirectoryScanner::scanCourse(const std::string& course_path) {
+Course DirectoryScanner::scanCourse(const std::string& course_path, DirectorySyscalls* syscalls) {
     Course course;
     course.path = course_path;
     course.name = StringUtils::getBaseName(course_path);
@@ -117,26 +610,33 @@ Course DirectoryScanner::scanCourse(const std::string& course_path) {
     // Replace underscores with spaces for display
     course.name = StringUtils::replaceAll(course.name, "_", " ");
 
-    course.videos = scanVideos(course_path);
+    // Read before the listing, so a change made meanwhile leaves a newer mtime
+    if (syscalls) paceStat(syscalls->throttle);
+    int64_t mtime = FileUtils::getModificationTime(course_path);
+    if (syscalls) syscalls->stats++;
+    int64_t racy_after = FileUtils::modificationTimeNow() -
+        std::chrono::duration_cast<fs::file_time_type::duration>(RACY_WINDOW).count();
+    course.mtime = mtime < racy_after ? mtime : 0;
+
+    course.videos = scanVideos(course_path, syscalls);
 
     Logger::debug("Found " + std::to_string(course.videos.size()) + " videos in course: " + course.name);
     return course;
 }
 
-std::vector<VideoFile> DirectoryScanner::scanVideos(const std::string& course_path) {
+std::vector<VideoFile> DirectoryScanner::scanVideos(const std::string& course_path,
+                                                    DirectorySyscalls* syscalls) {
     std::vector<VideoFile> videos;
 
-    auto entries = FileUtils::listDirectory(course_path);
-    for (const auto& entry : entries) {
-        std::string file_path = course_path + "/" + entry;
-
-        if (!FileUtils::isDirectory(file_path) && FileUtils::isVideoFile(entry)) {
+    // Only video files are stat()ed, and only once, for their size
+    auto entries = FileUtils::readDirectory(course_path, FileUtils::isVideoFile, syscalls);
+    for (auto& entry : entries) {
+        if (entry.type == DirectoryEntry::Type::FILE && FileUtils::isVideoFile(entry.name)) {
             VideoFile video;
-            video.name = entry;
-            video.path = file_path;
+            video.path = course_path + "/" + entry.name;
 
             // Create relative path from root
-            std::string relative = file_path;
+            std::string relative = video.path;
             if (relative.find(root_path_) == 0) {
                 relative = relative.substr(root_path_.length());
                 if (relative[0] == '/' || relative[0] == '\\') {
@@ -145,10 +645,11 @@ std::vector<VideoFile> DirectoryScanner::scanVideos(const std::string& course_pa
             }
             video.relative_path = relative;
 
-            video.size = FileUtils::getFileSize(file_path);
-            video.extension = StringUtils::getFileExtension(entry);
+            video.size = static_cast<size_t>(entry.size);
+            video.extension = StringUtils::getFileExtension(entry.name);
+            video.name = std::move(entry.name);
 
-            videos.push_back(video);
+            videos.push_back(std::move(video));
         }
     }
 
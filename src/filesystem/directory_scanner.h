@@ -2,24 +2,81 @@
 // src/filesystem/directory_scanner.h
 #pragma once
 #include "utils/types.h"
+#include "utils/flat_library.h"
+#include "filesystem/file_utils.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace utec {
 
+    class ScanThrottle;
+
     class DirectoryScanner {
     public:
-        explicit DirectoryScanner(const std::string& root_path);
+        struct ScanStats {
+            uint64_t threads = 0;
+            uint64_t directories = 0;
+            uint64_t wall_time_us = 0;
+            uint64_t busy_time_us = 0;   // summed over all workers
+            uint64_t directory_opens = 0;
+            uint64_t directory_reads = 0;
+            uint64_t stat_calls = 0;
+            uint64_t entries = 0;
+            uint64_t typed_entries = 0;  // entries that needed no stat for their type
+
+            // busy / wall: how many workers were effectively overlapping
+            double parallelism() const {
+                return wall_time_us ? static_cast<double>(busy_time_us) / wall_time_us : 0.0;
+            }
+        };
+
+        // Year, semester and course directories are enumerated by up to
+        // scan_threads workers; the result is ordered as with a serial scan.
+        // A lazy scanner's full scans stop at the course directories and
+        // leave the courses unscanned, for rescan() to list when needed
+        explicit DirectoryScanner(const std::string& root_path, size_t scan_threads = 1, bool lazy = false);
+
+        // paced: goes through the throttle at idle I/O priority. Listings a
+        // request is waiting for pass false and run at full speed
+        VideoLibrary scanLibrary(bool paced = true);
+
+        // Rescans the years, semesters and courses that contain the changed
+        // paths and copies the rest of current, course ranges at a time; a
+        // change to the root itself falls back to a full scan
+        FlatLibrary rescan(const FlatLibrary& current, const std::vector<std::string>& changed_paths,
+                           bool paced = true);
+
+        // Paths where the tree on disk no longer matches library, judged by
+        // the course directory mtimes; feed the result to rescan(). Unscanned
+        // courses are only reported when they disappear
+        std::vector<std::string> findChanges(const FlatLibrary& library);
+
+        // Paces every later change check and paced scan; nullptr scans at full speed
+        void setThrottle(std::shared_ptr<ScanThrottle> throttle);
+        std::shared_ptr<ScanThrottle> getThrottle() const { return throttle_; }
 
-        VideoLibrary scanLibrary();
         bool isValidStructure() const;
+        ScanStats lastScanStats() const;
+        const std::string& getRootPath() const { return root_path_; }
+        bool isLazy() const { return lazy_; }
 
     private:
         std::string root_path_;
+        size_t scan_threads_;
+        bool lazy_;
+        std::shared_ptr<ScanThrottle> throttle_;
+
+        mutable std::mutex stats_mutex_;
+        ScanStats last_stats_;
 
-        AcademicYear scanYear(const std::string& year_path);
-        Semester scanSemester(const std::string& semester_path);
-        Course scanCourse(const std::string& course_path);
-        std::vector<VideoFile> scanVideos(const std::string& course_path);
+        AcademicYear scanYear(const std::string& year, DirectorySyscalls& syscalls);
+        Semester scanSemester(const std::string& year, const std::string& semester, DirectorySyscalls& syscalls);
+        Course scanCourse(const std::string& course_path, DirectorySyscalls* syscalls);
+        std::vector<VideoFile> scanVideos(const std::string& course_path, DirectorySyscalls* syscalls);
     };
 
 } // namespace utec
\ No newline at end of file
@@ -0,0 +1,239 @@
+// src/filesystem/file_handle_cache.cpp
+#include "filesystem/file_handle_cache.h"
+#include "filesystem/mapped_file.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace utec {
+
+namespace {
+
+    struct FileStat {
+        size_t size = 0;
+        uint64_t device = 0;
+        uint64_t inode = 0;
+        int64_t mtime_ns = 0;
+    };
+
+#ifdef _WIN32
+    FileStat toFileStat(const struct _stat64& st) {
+        FileStat result;
+        result.size = static_cast<size_t>(st.st_size);
+        result.device = static_cast<uint64_t>(st.st_dev);
+        result.inode = static_cast<uint64_t>(st.st_ino);
+        result.mtime_ns = static_cast<int64_t>(st.st_mtime) * 1000000000LL;
+        return result;
+    }
+
+    bool statPath(const std::string& path, FileStat& out) {
+        struct _stat64 st;
+        if (::_stat64(path.c_str(), &st) != 0 || !(st.st_mode & _S_IFREG)) {
+            return false;
+        }
+        out = toFileStat(st);
+        return true;
+    }
+
+    bool statDescriptor(int fd, FileStat& out) {
+        struct _stat64 st;
+        if (::_fstat64(fd, &st) != 0 || !(st.st_mode & _S_IFREG)) {
+            return false;
+        }
+        out = toFileStat(st);
+        return true;
+    }
+#else
+    FileStat toFileStat(const struct stat& st) {
+        FileStat result;
+        result.size = static_cast<size_t>(st.st_size);
+        result.device = static_cast<uint64_t>(st.st_dev);
+        result.inode = static_cast<uint64_t>(st.st_ino);
+#ifdef __APPLE__
+        result.mtime_ns = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000LL +
+                          st.st_mtimespec.tv_nsec;
+#else
+        result.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL +
+                          st.st_mtim.tv_nsec;
+#endif
+        return result;
+    }
+
+    bool statPath(const std::string& path, FileStat& out) {
+        struct stat st;
+        if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+            return false;
+        }
+        out = toFileStat(st);
+        return true;
+    }
+
+    bool statDescriptor(int fd, FileStat& out) {
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            return false;
+        }
+        out = toFileStat(st);
+        return true;
+    }
+#endif
+
+} // namespace
+
+FileHandle::~FileHandle() {
+    if (fd_ >= 0) {
+#ifdef _WIN32
+        ::_close(fd_);
+#else
+        ::close(fd_);
+#endif
+    }
+}
+
+long long FileHandle::read(char* buffer, size_t length, size_t offset) const {
+#ifdef _WIN32
+    std::lock_guard<std::mutex> lock(read_mutex_);
+    if (::_lseeki64(fd_, static_cast<long long>(offset), SEEK_SET) < 0) {
+        return -1;
+    }
+    return ::_read(fd_, buffer, static_cast<unsigned int>(length));
+#else
+    ssize_t bytes_read;
+    do {
+        bytes_read = ::pread(fd_, buffer, length, static_cast<off_t>(offset));
+    } while (bytes_read < 0 && errno == EINTR);
+    return bytes_read;
+#endif
+}
+
+std::shared_ptr<MappedFile> FileHandle::mapping() {
+    std::lock_guard<std::mutex> lock(mapping_mutex_);
+    if (!mapping_) {
+#ifdef _WIN32
+        mapping_ = MappedFile::open(path_);
+#else
+        mapping_ = MappedFile::fromDescriptor(fd_, size_);
+#endif
+    }
+    return mapping_;
+}
+
+FileHandleCache::FileHandleCache(size_t max_entries, std::chrono::milliseconds revalidate_interval)
+    : max_entries_(max_entries), revalidate_interval_(revalidate_interval) {
+}
+
+std::shared_ptr<FileHandle> FileHandleCache::acquire(const std::string& normalized_path) {
+    auto now = std::chrono::steady_clock::now();
+    std::shared_ptr<FileHandle> cached;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(normalized_path);
+        if (it != entries_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+            if (now - it->second.validated_at < revalidate_interval_) {
+                return it->second.handle;
+            }
+            cached = it->second.handle;
+        }
+    }
+
+    // Revalidate outside the lock: on a network mount stat() is a round trip
+    FileStat current;
+    if (!statPath(normalized_path, current)) {
+        erase(normalized_path);
+        return nullptr;
+    }
+
+    if (cached && cached->inode_ == current.inode && cached->device_ == current.device &&
+        cached->size_ == current.size && cached->mtime_ns_ == current.mtime_ns) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(normalized_path);
+        if (it != entries_.end() && it->second.handle == cached) {
+            it->second.validated_at = now;
+        }
+        return cached;
+    }
+
+    auto handle = openHandle(normalized_path);
+    if (!handle) {
+        erase(normalized_path);
+        return nullptr;
+    }
+
+    insert(normalized_path, handle);
+    return handle;
+}
+
+void FileHandleCache::invalidate(const std::string& normalized_path) {
+    erase(normalized_path);
+}
+
+size_t FileHandleCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+std::shared_ptr<FileHandle> FileHandleCache::openHandle(const std::string& path) {
+    std::shared_ptr<FileHandle> handle(new FileHandle());
+    handle->path_ = path;
+
+#ifdef _WIN32
+    handle->fd_ = ::_open(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+    handle->fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+    if (handle->fd_ < 0) {
+        return nullptr;
+    }
+
+    FileStat st;
+    if (!statDescriptor(handle->fd_, st)) {
+        return nullptr;
+    }
+
+    handle->size_ = st.size;
+    handle->device_ = st.device;
+    handle->inode_ = st.inode;
+    handle->mtime_ns_ = st.mtime_ns;
+    return handle;
+}
+
+void FileHandleCache::insert(const std::string& path, std::shared_ptr<FileHandle> handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+
+    auto it = entries_.find(path);
+    if (it != entries_.end()) {
+        it->second.handle = std::move(handle);
+        it->second.validated_at = now;
+        lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+        return;
+    }
+
+    lru_.push_front(path);
+    entries_[path] = Entry{std::move(handle), now, lru_.begin()};
+
+    // Evicted handles stay open until the last stream using them finishes
+    while (entries_.size() > max_entries_ && !lru_.empty()) {
+        entries_.erase(lru_.back());
+        lru_.pop_back();
+    }
+}
+
+void FileHandleCache::erase(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(path);
+    if (it != entries_.end()) {
+        lru_.erase(it->second.lru_position);
+        entries_.erase(it);
+    }
+}
+
+} // namespace utec
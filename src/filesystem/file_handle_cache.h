@@ -0,0 +1,83 @@
+// src/filesystem/file_handle_cache.h
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace utec {
+
+    class MappedFile;
+
+    // An open, read-only file together with the metadata it was opened with
+    class FileHandle {
+    public:
+        ~FileHandle();
+        FileHandle(const FileHandle&) = delete;
+        FileHandle& operator=(const FileHandle&) = delete;
+
+        const std::string& path() const { return path_; }
+        size_t size() const { return size_; }
+        uint64_t device() const { return device_; }
+        uint64_t inode() const { return inode_; }
+        int64_t mtime() const { return mtime_ns_; }
+        int descriptor() const { return fd_; }
+
+        // Positional read; safe to call from several streams at once
+        long long read(char* buffer, size_t length, size_t offset) const;
+
+        // Mapping of the whole file, created on first use and shared afterwards
+        std::shared_ptr<MappedFile> mapping();
+
+    private:
+        friend class FileHandleCache;
+        FileHandle() = default;
+
+        std::string path_;
+        int fd_ = -1;
+        size_t size_ = 0;
+        uint64_t device_ = 0;
+        uint64_t inode_ = 0;
+        int64_t mtime_ns_ = 0;
+
+        std::mutex mapping_mutex_;
+        std::shared_ptr<MappedFile> mapping_;
+#ifdef _WIN32
+        mutable std::mutex read_mutex_;
+#endif
+    };
+
+    // Size-bounded LRU of open files keyed by normalized path. Entries are
+    // re-stat'ed at most once per revalidate interval and reopened when the
+    // inode, size or mtime changed, so a hot path costs no metadata syscalls.
+    class FileHandleCache {
+    public:
+        FileHandleCache(size_t max_entries, std::chrono::milliseconds revalidate_interval);
+
+        // Returns nullptr if the file does not exist or cannot be opened
+        std::shared_ptr<FileHandle> acquire(const std::string& normalized_path);
+        void invalidate(const std::string& normalized_path);
+        size_t size() const;
+
+    private:
+        struct Entry {
+            std::shared_ptr<FileHandle> handle;
+            std::chrono::steady_clock::time_point validated_at;
+            std::list<std::string>::iterator lru_position;
+        };
+
+        size_t max_entries_;
+        std::chrono::milliseconds revalidate_interval_;
+        std::unordered_map<std::string, Entry> entries_;
+        std::list<std::string> lru_;
+        mutable std::mutex mutex_;
+
+        static std::shared_ptr<FileHandle> openHandle(const std::string& path);
+        void insert(const std::string& path, std::shared_ptr<FileHandle> handle);
+        void erase(const std::string& path);
+    };
+
+} // namespace utec
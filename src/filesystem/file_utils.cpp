@@ -1,8 +1,18 @@
 // src/filesystem/file_utils.cpp
 #include "filesystem/file_utils.h"
+#include "filesystem/scan_throttle.h"
 #include "utils/string_utils.h"
 #include <filesystem>
 #include <algorithm>
+#include <chrono>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace fs = std::filesystem;
 
@@ -34,6 +44,16 @@ size_t FileUtils::getFileSize(const std::string& path) {
     }
 }
 
+int64_t FileUtils::getModificationTime(const std::string& path) {
+    std::error_code ec;
+    auto time = fs::last_write_time(path, ec);
+    return ec ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+int64_t FileUtils::modificationTimeNow() {
+    return static_cast<int64_t>(fs::file_time_type::clock::now().time_since_epoch().count());
+}
+
 std::vector<std::string> FileUtils::listDirectory(const std::string& path) {
     std::vector<std::string> entries;
 
@@ -51,6 +71,177 @@ std::vector<std::string> FileUtils::listDirectory(const std::string& path) {
     return entries;
 }
 
+#ifdef __linux__
+
+namespace {
+
+// Layout returned by getdents64; glibc only declares it in recent versions
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+void count(std::atomic<uint64_t> DirectorySyscalls::*counter, DirectorySyscalls* syscalls) {
+    if (syscalls) {
+        (syscalls->*counter).fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void pace(ScanThrottle::Op op, DirectorySyscalls* syscalls) {
+    if (syscalls && syscalls->throttle) {
+        syscalls->throttle->acquire(op);
+    }
+}
+
+// Resolves type (following symlinks) and, when asked, size with a single call
+bool statEntry(int dir_fd, const char* name, bool want_size, DirectoryEntry& entry,
+               DirectorySyscalls* syscalls) {
+    pace(ScanThrottle::Op::STAT, syscalls);
+    count(&DirectorySyscalls::stats, syscalls);
+#ifdef STATX_SIZE
+    struct statx info;
+    unsigned int mask = STATX_TYPE | (want_size ? STATX_SIZE | STATX_MTIME : 0);
+    if (::statx(dir_fd, name, AT_STATX_SYNC_AS_STAT, mask, &info) != 0) {
+        return false;
+    }
+    mode_t mode = info.stx_mode;
+    entry.size = want_size ? info.stx_size : 0;
+    entry.mtime = want_size ? static_cast<int64_t>(info.stx_mtime.tv_sec) : 0;
+#else
+    struct stat info;
+    if (::fstatat(dir_fd, name, &info, 0) != 0) {
+        return false;
+    }
+    mode_t mode = info.st_mode;
+    entry.size = want_size ? static_cast<uint64_t>(info.st_size) : 0;
+    entry.mtime = want_size ? static_cast<int64_t>(info.st_mtime) : 0;
+#endif
+    entry.type = S_ISDIR(mode) ? DirectoryEntry::Type::DIRECTORY
+               : S_ISREG(mode) ? DirectoryEntry::Type::FILE
+                               : DirectoryEntry::Type::OTHER;
+    return true;
+}
+
+} // namespace
+
+std::vector<DirectoryEntry> FileUtils::readDirectory(const std::string& path,
+                                                     const std::function<bool(const std::string&)>& want_size,
+                                                     DirectorySyscalls* syscalls) {
+    std::vector<DirectoryEntry> entries;
+
+    pace(ScanThrottle::Op::LIST, syscalls);
+    count(&DirectorySyscalls::opens, syscalls);
+    int dir_fd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd < 0) {
+        return entries;
+    }
+
+    alignas(LinuxDirent64) char buffer[32 * 1024];
+    while (true) {
+        count(&DirectorySyscalls::reads, syscalls);
+        long bytes = ::syscall(SYS_getdents64, dir_fd, buffer, sizeof(buffer));
+        if (bytes <= 0) {
+            break;
+        }
+
+        for (long offset = 0; offset < bytes;) {
+            auto* dirent = reinterpret_cast<LinuxDirent64*>(buffer + offset);
+            offset += dirent->d_reclen;
+
+            const char* name = dirent->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                continue;
+            }
+            count(&DirectorySyscalls::entries, syscalls);
+
+            DirectoryEntry entry;
+            entry.name = name;
+            bool need_size = want_size && dirent->d_type != DT_DIR && want_size(entry.name);
+
+            // d_type answers for directories and plain files on local filesystems
+            // and most NFS servers; symlinks and DT_UNKNOWN still need a stat
+            switch (dirent->d_type) {
+                case DT_DIR:
+                    entry.type = DirectoryEntry::Type::DIRECTORY;
+                    count(&DirectorySyscalls::typed_entries, syscalls);
+                    break;
+                case DT_REG:
+                    entry.type = DirectoryEntry::Type::FILE;
+                    count(&DirectorySyscalls::typed_entries, syscalls);
+                    if (need_size && !statEntry(dir_fd, name, true, entry, syscalls)) {
+                        continue;
+                    }
+                    break;
+                case DT_LNK:
+                case DT_UNKNOWN:
+                    if (!statEntry(dir_fd, name, need_size, entry, syscalls)) {
+                        continue;
+                    }
+                    break;
+                default:
+                    entry.type = DirectoryEntry::Type::OTHER;
+                    count(&DirectorySyscalls::typed_entries, syscalls);
+                    break;
+            }
+            entries.push_back(std::move(entry));
+        }
+    }
+    ::close(dir_fd);
+
+    // Sort entries for consistent ordering
+    std::sort(entries.begin(), entries.end(),
+              [](const DirectoryEntry& a, const DirectoryEntry& b) { return a.name < b.name; });
+    return entries;
+}
+
+#else
+
+std::vector<DirectoryEntry> FileUtils::readDirectory(const std::string& path,
+                                                     const std::function<bool(const std::string&)>& want_size,
+                                                     DirectorySyscalls* syscalls) {
+    std::vector<DirectoryEntry> entries;
+
+    // directory_entry caches the attributes the platform listing returns
+    // (all of them on Windows), so most queries below do not stat again
+    try {
+        if (syscalls && syscalls->throttle) syscalls->throttle->acquire(ScanThrottle::Op::LIST);
+        if (syscalls) syscalls->opens++;
+        for (const auto& dir_entry : fs::directory_iterator(path)) {
+            if (syscalls) syscalls->entries++;
+            std::error_code ec;
+            DirectoryEntry entry;
+            entry.name = dir_entry.path().filename().string();
+            if (dir_entry.is_directory(ec)) {
+                entry.type = DirectoryEntry::Type::DIRECTORY;
+            } else if (dir_entry.is_regular_file(ec)) {
+                entry.type = DirectoryEntry::Type::FILE;
+                if (want_size && want_size(entry.name)) {
+                    entry.size = dir_entry.file_size(ec);
+                    // file_time_type has no defined epoch before C++20; its
+                    // distance from now carries over to the system clock
+                    auto age = fs::file_time_type::clock::now() - dir_entry.last_write_time(ec);
+                    entry.mtime = std::chrono::duration_cast<std::chrono::seconds>(
+                        (std::chrono::system_clock::now() -
+                         std::chrono::duration_cast<std::chrono::system_clock::duration>(age))
+                            .time_since_epoch()).count();
+                }
+            }
+            entries.push_back(std::move(entry));
+        }
+    } catch (const fs::filesystem_error&) {
+        // Return what was read so far
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [](const DirectoryEntry& a, const DirectoryEntry& b) { return a.name < b.name; });
+    return entries;
+}
+
+#endif
+
 std::string FileUtils::getAbsolutePath(const std::string& path) {
     try {
         return fs::absolute(path).string();
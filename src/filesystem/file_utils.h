@@ -1,18 +1,52 @@
 // src/filesystem/file_utils.h
 #pragma once
 #include "utils/types.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
 namespace utec {
 
+    class ScanThrottle;
+
+    struct DirectoryEntry {
+        enum class Type { FILE, DIRECTORY, OTHER };
+
+        std::string name;
+        Type type = Type::OTHER;
+        uint64_t size = 0;   // only for files the caller asked sizes for
+        int64_t mtime = 0;   // seconds since the epoch, read along with the size
+    };
+
+    // System calls made by readDirectory, summed over a whole scan
+    struct DirectorySyscalls {
+        std::atomic<uint64_t> opens{0};
+        std::atomic<uint64_t> reads{0};          // getdents64 (or readdir batches)
+        std::atomic<uint64_t> stats{0};
+        std::atomic<uint64_t> entries{0};
+        std::atomic<uint64_t> typed_entries{0};  // type known without a stat
+        ScanThrottle* throttle = nullptr;        // paces the opens and stats when set
+    };
+
     class FileUtils {
     public:
         static bool exists(const std::string& path);
         static bool isDirectory(const std::string& path);
         static bool isVideoFile(const std::string& filename);
         static size_t getFileSize(const std::string& path);
+        // Opaque filesystem timestamp, only meant for comparison; 0 when unknown
+        static int64_t getModificationTime(const std::string& path);
+        static int64_t modificationTimeNow();
         static std::vector<std::string> listDirectory(const std::string& path);
+
+        // One pass over a directory, sorted by name. The entry type comes from
+        // the directory listing itself; only files accepted by want_size (and
+        // entries of unknown type) cost a stat.
+        static std::vector<DirectoryEntry> readDirectory(const std::string& path,
+                                                         const std::function<bool(const std::string&)>& want_size,
+                                                         DirectorySyscalls* syscalls = nullptr);
         static std::string getAbsolutePath(const std::string& path);
         static std::string normalizePath(const std::string& path);
 
@@ -0,0 +1,265 @@
+// src/filesystem/library_index.cpp
+#include "filesystem/library_index.h"
+#include "filesystem/mapped_file.h"
+#include "utils/string_utils.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+namespace fs = std::filesystem;
+
+namespace utec {
+
+namespace {
+
+constexpr char INDEX_MAGIC[8] = {'U', 'T', 'E', 'C', 'L', 'I', 'B', 'X'};
+constexpr uint32_t INDEX_VERSION = 2;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// Per-course flags
+constexpr uint64_t COURSE_UNSCANNED = 1;  // left for a lazy scan to list
+
+// Written in native byte order; an index from another architecture fails
+// the byte order check and is rebuilt by a scan
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    int64_t epoch;
+    uint64_t generation;
+    int64_t generation_time;
+    uint64_t course_count;
+    uint64_t video_count;
+    uint64_t root_length;
+    uint64_t payload_length;
+    uint64_t checksum;  // FNV-1a over the root path and the payload
+};
+
+uint64_t checksum(uint64_t hash, const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Stores the length shared with previous and the remaining suffix
+void putFrontCoded(std::string& out, std::string_view previous, std::string_view value) {
+    size_t shared = 0;
+    size_t limit = std::min(previous.size(), value.size());
+    while (shared < limit && previous[shared] == value[shared]) {
+        ++shared;
+    }
+    putVarint(out, shared);
+    putVarint(out, value.size() - shared);
+    out.append(value.substr(shared));
+}
+
+class Reader {
+public:
+    Reader(const char* data, size_t size) : pos_(data), end_(data + size) {}
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return pos_ == end_; }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos_ == end_) {
+                break;
+            }
+            auto byte = static_cast<unsigned char>(*pos_++);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        ok_ = false;
+        return 0;
+    }
+
+    // Rebuilds value in place from the previous entry it was coded against
+    void frontCoded(std::string& value) {
+        uint64_t shared = varint();
+        uint64_t suffix = varint();
+        if (!ok_ || shared > value.size() || suffix > static_cast<uint64_t>(end_ - pos_)) {
+            ok_ = false;
+            return;
+        }
+        value.resize(static_cast<size_t>(shared));
+        value.append(pos_, static_cast<size_t>(suffix));
+        pos_ += suffix;
+    }
+
+private:
+    const char* pos_;
+    const char* end_;
+    bool ok_ = true;
+};
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+} // namespace
+
+bool LibraryIndex::save(const std::string& path, const std::string& root_path,
+                        const FlatLibrary& library, const Info& info) {
+    std::string payload;
+    std::string previous_course;
+    uint64_t course_count = library.courseCount();
+    uint64_t video_count = library.videoCount();
+
+    for (FlatLibrary::Index c = 0; c < library.courseCount(); ++c) {
+        std::string relative = library.courseRelativePath(c);
+        putFrontCoded(payload, previous_course, relative);
+        previous_course = std::move(relative);
+        putVarint(payload, zigzag(library.courseMtime(c)));
+        putVarint(payload, library.courseScanned(c) ? 0 : COURSE_UNSCANNED);
+        putVarint(payload, library.courseVideoCount(c));
+
+        std::string_view previous_name;
+        for (FlatLibrary::Index v = library.videoBegin(c); v < library.videoEnd(c); ++v) {
+            putFrontCoded(payload, previous_name, library.videoName(v));
+            previous_name = library.videoName(v);
+            putVarint(payload, library.videoSize(v));
+        }
+    }
+
+    IndexHeader header{};
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.epoch = info.epoch;
+    header.generation = info.generation;
+    header.generation_time = info.generation_time;
+    header.course_count = course_count;
+    header.video_count = video_count;
+    header.root_length = root_path.size();
+    header.payload_length = payload.size();
+    header.checksum = checksum(checksum(14695981039346656037ULL, root_path.data(), root_path.size()),
+                               payload.data(), payload.size());
+
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(root_path.data(), static_cast<std::streamsize>(root_path.size()));
+        out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        if (!out) {
+            Logger::warning("Could not write library index: " + temp_path);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(temp_path, path, ec);
+    if (ec) {
+        Logger::warning("Could not replace library index " + path + ": " + ec.message());
+        fs::remove(temp_path, ec);
+        return false;
+    }
+
+    Logger::debug("Library index saved: " + std::to_string(course_count) + " courses, " +
+                  std::to_string(video_count) + " videos in " + std::to_string(sizeof(header) + root_path.size() +
+                  payload.size()) + " bytes");
+    return true;
+}
+
+bool LibraryIndex::load(const std::string& path, const std::string& root_path,
+                        FlatLibrary& library, Info& info) {
+    auto file = MappedFile::open(path);
+    if (!file || file->size() < sizeof(IndexHeader)) {
+        return false;
+    }
+
+    IndexHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != INDEX_VERSION || header.byte_order != BYTE_ORDER_MARK) {
+        Logger::warning("Ignoring library index with an unknown format: " + path);
+        return false;
+    }
+
+    size_t available = file->size() - sizeof(header);
+    if (header.root_length > available || header.payload_length != available - header.root_length) {
+        Logger::warning("Ignoring truncated library index: " + path);
+        return false;
+    }
+    const char* root = file->data() + sizeof(header);
+    const char* payload = root + header.root_length;
+    if (std::string(root, static_cast<size_t>(header.root_length)) != root_path) {
+        Logger::info("Library index was written for another root, rescanning");
+        return false;
+    }
+    if (checksum(checksum(14695981039346656037ULL, root, static_cast<size_t>(header.root_length)),
+                 payload, static_cast<size_t>(header.payload_length)) != header.checksum) {
+        Logger::warning("Ignoring damaged library index: " + path);
+        return false;
+    }
+
+    FlatLibrary loaded(root_path);
+    Reader reader(payload, static_cast<size_t>(header.payload_length));
+    std::string relative;
+    std::string year;
+    std::string semester;
+    for (uint64_t c = 0; c < header.course_count && reader.ok(); ++c) {
+        reader.frontCoded(relative);
+        auto parts = StringUtils::split(relative, '/');
+        if (parts.size() != 3) {
+            return false;
+        }
+
+        // Courses are stored in library order, so a year or semester starts
+        // where its name first differs from the course before
+        bool new_year = loaded.yearCount() == 0 || year != parts[0];
+        if (new_year) {
+            year = parts[0];
+            loaded.addYear(year);
+        }
+        if (new_year || semester != parts[1]) {
+            semester = parts[1];
+            loaded.addSemester(semester);
+        }
+        int64_t mtime = unzigzag(reader.varint());
+        uint64_t flags = reader.varint();
+        loaded.addCourse(parts[2], mtime, !(flags & COURSE_UNSCANNED));
+
+        uint64_t videos = reader.varint();
+        std::string name;
+        for (uint64_t v = 0; v < videos && reader.ok(); ++v) {
+            reader.frontCoded(name);
+            loaded.addVideo(name, reader.varint());
+        }
+    }
+
+    if (!reader.ok() || !reader.atEnd()) {
+        Logger::warning("Ignoring damaged library index: " + path);
+        return false;
+    }
+
+    loaded.finish();
+    library = std::move(loaded);
+    info.epoch = header.epoch;
+    info.generation = header.generation;
+    info.generation_time = header.generation_time;
+    Logger::info("Loaded library index: " + std::to_string(header.course_count) + " courses, " +
+                 std::to_string(header.video_count) + " videos");
+    return true;
+}
+
+} // namespace utec
@@ -0,0 +1,31 @@
+// src/filesystem/library_index.h
+#pragma once
+#include "utils/flat_library.h"
+#include <cstdint>
+#include <string>
+
+namespace utec {
+
+    // Binary snapshot of the library kept between runs, so a restart serves
+    // the previous listing at once and checks it against the disk afterwards.
+    // Course paths and file names are front-coded against the entry before
+    // them; loading maps the file and decodes it in a single pass.
+    class LibraryIndex {
+    public:
+        struct Info {
+            long long epoch = 0;          // ETag epoch of the run that wrote it
+            uint64_t generation = 0;
+            long long generation_time = 0;
+        };
+
+        // False when the file is missing, damaged, or written for another root
+        // or format version; library and info are left untouched then
+        static bool load(const std::string& path, const std::string& root_path,
+                         FlatLibrary& library, Info& info);
+
+        // Written next to path and renamed over it, so readers never see half a file
+        static bool save(const std::string& path, const std::string& root_path,
+                         const FlatLibrary& library, const Info& info);
+    };
+
+} // namespace utec
@@ -0,0 +1,227 @@
+// src/filesystem/library_poller.cpp
+#include "filesystem/library_poller.h"
+#include "filesystem/file_utils.h"
+#include "filesystem/scan_throttle.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace utec {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Courses hold the videos; nothing below them is part of the library
+constexpr int MAX_DEPTH = 3;
+
+// Network filesystems may store coarse timestamps, and a directory changed
+// within the same tick as its listing keeps the mtime that was recorded
+constexpr auto RACY_WINDOW = std::chrono::seconds(2);
+
+// A video modified more recently than this may still be copied in. NFS
+// clients cache attributes for up to a minute, so the mtime seen can lag
+// the last write by that much
+constexpr auto SETTLE_TIME = std::chrono::seconds(120);
+
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+uint64_t hashName(uint64_t hash, const std::string& name) {
+    // The terminating NUL keeps "ab" + "c" apart from "a" + "bc"
+    return hashBytes(hash, name.c_str(), name.size() + 1);
+}
+
+} // namespace
+
+LibraryPoller::LibraryPoller(const std::string& root_path, std::chrono::seconds interval, ChangeCallback callback,
+                             std::shared_ptr<ScanThrottle> throttle)
+    : root_path_(FileUtils::getAbsolutePath(root_path)), interval_(interval), callback_(std::move(callback)),
+      throttle_(std::move(throttle)) {
+}
+
+LibraryPoller::~LibraryPoller() {
+    stop();
+}
+
+void LibraryPoller::start() {
+    if (thread_.joinable()) {
+        return;
+    }
+    stopping_ = false;
+    thread_ = std::thread([this]() { run(); });
+    Logger::info("Checking the library for changes every " + std::to_string(interval_.count()) + " seconds");
+}
+
+void LibraryPoller::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void LibraryPoller::ensureBaseline(bool paced) {
+    std::lock_guard<std::mutex> lock(tree_mutex_);
+    if (!has_baseline_) {
+        update(false, paced);
+    }
+}
+
+std::vector<std::string> LibraryPoller::refresh() {
+    std::lock_guard<std::mutex> lock(tree_mutex_);
+    return update(true, true);
+}
+
+LibraryPoller::Stats LibraryPoller::stats() const {
+    std::lock_guard<std::mutex> lock(tree_mutex_);
+    return stats_;
+}
+
+std::vector<std::string> LibraryPoller::update(bool report, bool paced) {
+    syscalls_.throttle = paced ? throttle_.get() : nullptr;
+    IdleIoPriority io_priority(syscalls_.throttle);
+    auto start = Clock::now();
+    int64_t racy_after = (fs::file_time_type::clock::now() -
+                          std::chrono::duration_cast<fs::file_time_type::duration>(RACY_WINDOW))
+                         .time_since_epoch().count();
+    int64_t settled_before = std::chrono::duration_cast<std::chrono::seconds>(
+        (std::chrono::system_clock::now() - SETTLE_TIME).time_since_epoch()).count();
+
+    std::vector<std::string> changed;
+    uint64_t listings = 0;
+    uint64_t directories = 0;
+    uint64_t settling = 0;
+    refreshNode(root_, root_path_, 0, racy_after, settled_before, report && has_baseline_, changed,
+                listings, directories, settling);
+    has_baseline_ = true;
+
+    ++stats_.refreshes;
+    stats_.directories = directories;
+    stats_.last_refresh_us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+    stats_.last_listings = listings;
+    stats_.settling_courses = settling;
+    stats_.changed_paths += changed.size();
+
+    Logger::debug("Library refresh: " + std::to_string(directories) + " directories, " +
+                  std::to_string(listings) + " listed, " + std::to_string(changed.size()) +
+                  " changed paths in " + std::to_string(stats_.last_refresh_us) + " us");
+    return changed;
+}
+
+void LibraryPoller::refreshNode(Node& node, const std::string& path, int depth, int64_t racy_after,
+                                int64_t settled_before, bool report, std::vector<std::string>& changed,
+                                uint64_t& listings, uint64_t& directories, uint64_t& settling) {
+    ++directories;
+
+    // The mtime is read before listing, so a change made during the listing
+    // leaves a newer mtime behind for the next refresh
+    if (syscalls_.throttle) {
+        syscalls_.throttle->acquire(ScanThrottle::Op::STAT);
+    }
+    std::error_code ec;
+    auto mtime = fs::last_write_time(path, ec);
+    if (ec) {
+        // Removed meanwhile; the parent's listing reports it
+        return;
+    }
+    int64_t mtime_value = mtime.time_since_epoch().count();
+
+    if (!node.listed || node.racy || node.settling || mtime_value != node.mtime) {
+        ++listings;
+        bool course = depth == MAX_DEPTH;
+        auto entries = FileUtils::readDirectory(path, course ? FileUtils::isVideoFile : nullptr, &syscalls_);
+
+        uint64_t listing_hash = FNV_OFFSET;
+        int64_t newest_video = 0;
+        std::map<std::string, Node> children;
+        for (auto& entry : entries) {
+            if (course) {
+                if (entry.type == DirectoryEntry::Type::FILE && FileUtils::isVideoFile(entry.name)) {
+                    listing_hash = hashName(listing_hash, entry.name);
+                    listing_hash = hashBytes(listing_hash, &entry.size, sizeof(entry.size));
+                    newest_video = std::max(newest_video, entry.mtime);
+                }
+            } else if (entry.type == DirectoryEntry::Type::DIRECTORY) {
+                listing_hash = hashName(listing_hash, entry.name);
+                auto existing = node.children.find(entry.name);
+                if (existing != node.children.end()) {
+                    children.emplace(entry.name, std::move(existing->second));
+                } else {
+                    // Scanned as a whole by the library; its own subtree is not reported
+                    children.emplace(entry.name, Node());
+                    if (report && node.listed) {
+                        changed.push_back(path + "/" + entry.name);
+                    }
+                }
+            }
+        }
+
+        if (report && node.listed) {
+            if (course) {
+                if (listing_hash != node.listing_hash) {
+                    changed.push_back(path);
+                }
+            } else {
+                for (const auto& child : node.children) {
+                    if (!children.count(child.first)) {
+                        changed.push_back(path + "/" + child.first);
+                    }
+                }
+            }
+        }
+
+        node.children = std::move(children);
+        node.listing_hash = listing_hash;
+        node.mtime = mtime_value;
+        node.listed = true;
+        node.racy = mtime_value >= racy_after;
+        node.settling = newest_video >= settled_before;
+    }
+    if (node.settling) {
+        ++settling;
+    }
+
+    // Directory mtimes do not propagate upwards, so every subdirectory is
+    // still stat()ed
+    for (auto& child : node.children) {
+        refreshNode(child.second, path + "/" + child.first, depth + 1, racy_after, settled_before, report,
+                    changed, listings, directories, settling);
+    }
+}
+
+void LibraryPoller::run() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            if (wake_.wait_for(lock, interval_, [this]() { return stopping_; })) {
+                return;
+            }
+        }
+
+        try {
+            auto changed = refresh();
+            if (!changed.empty()) {
+                callback_(changed);
+            }
+        } catch (const std::exception& e) {
+            Logger::error("Library refresh failed: " + std::string(e.what()));
+        }
+    }
+}
+
+} // namespace utec
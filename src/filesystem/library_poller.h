@@ -0,0 +1,97 @@
+// src/filesystem/library_poller.h
+#pragma once
+#include "filesystem/file_utils.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace utec {
+
+    class ScanThrottle;
+
+    // Periodic change detection for mounts where inotify only sees local
+    // writes (NFS, SMB). Every library directory is kept in a tree of
+    // (mtime, listing hash); a refresh stats each directory once and only
+    // lists the ones whose mtime moved, so an unchanged tree costs one stat
+    // per directory and no getdents or file stats.
+    //
+    // Appending to a file does not change its directory's mtime either, so a
+    // course is also listed again while it holds a video modified within the
+    // last couple of minutes: a video still being copied is followed until
+    // its size settles. A settled video rewritten in place is only seen once
+    // something else in that course changes.
+    class LibraryPoller {
+    public:
+        struct Stats {
+            uint64_t refreshes = 0;
+            uint64_t directories = 0;       // in the tree
+            uint64_t last_refresh_us = 0;
+            uint64_t last_listings = 0;     // directories re-listed by the last refresh
+            uint64_t settling_courses = 0;  // holding a recently modified video
+            uint64_t changed_paths = 0;     // reported since start
+        };
+
+        using ChangeCallback = std::function<void(const std::vector<std::string>& changed_paths)>;
+
+        // The throttle, when given, paces the stats and listings of a refresh
+        LibraryPoller(const std::string& root_path, std::chrono::seconds interval, ChangeCallback callback,
+                      std::shared_ptr<ScanThrottle> throttle = nullptr);
+        ~LibraryPoller();
+
+        LibraryPoller(const LibraryPoller&) = delete;
+        LibraryPoller& operator=(const LibraryPoller&) = delete;
+
+        void start();
+        void stop();
+
+        // Records the current tree without reporting anything. Called before a
+        // full scan, so every later change is newer than the scanned library;
+        // unpaced when a request is waiting for that scan
+        void ensureBaseline(bool paced = true);
+
+        // Brings the tree up to date and returns the paths that changed
+        std::vector<std::string> refresh();
+        Stats stats() const;
+
+    private:
+        struct Node {
+            int64_t mtime = 0;
+            bool listed = false;
+            bool racy = false;       // modified too close to the listing to trust the mtime
+            bool settling = false;   // a course whose newest video may still be growing
+            uint64_t listing_hash = 0;
+            std::map<std::string, Node> children;
+        };
+
+        std::string root_path_;
+        std::chrono::seconds interval_;
+        ChangeCallback callback_;
+        std::shared_ptr<ScanThrottle> throttle_;
+
+        mutable std::mutex tree_mutex_;
+        Node root_;
+        bool has_baseline_ = false;
+        Stats stats_;
+        DirectorySyscalls syscalls_;
+
+        std::mutex wake_mutex_;
+        std::condition_variable wake_;
+        bool stopping_ = false;
+        std::thread thread_;
+
+        std::vector<std::string> update(bool report, bool paced);
+        void refreshNode(Node& node, const std::string& path, int depth, int64_t racy_after,
+                         int64_t settled_before, bool report, std::vector<std::string>& changed,
+                         uint64_t& listings, uint64_t& directories, uint64_t& settling);
+        void run();
+    };
+
+} // namespace utec
@@ -0,0 +1,256 @@
+// src/filesystem/library_watcher.cpp
+#include "filesystem/library_watcher.h"
+#include "filesystem/file_utils.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace utec {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Courses hold the videos; nothing below them is part of the library
+constexpr int MAX_WATCH_DEPTH = 3;
+
+} // namespace
+
+LibraryWatcher::LibraryWatcher(const std::string& root_path, std::chrono::milliseconds coalesce_delay,
+                               std::chrono::milliseconds max_delay, ChangeCallback callback)
+    : root_path_(FileUtils::getAbsolutePath(root_path)), coalesce_delay_(coalesce_delay),
+      max_delay_(std::max(max_delay, coalesce_delay)), callback_(std::move(callback)) {
+}
+
+LibraryWatcher::~LibraryWatcher() {
+    stop();
+}
+
+LibraryWatcher::Stats LibraryWatcher::stats() const {
+    Stats stats;
+    stats.watches = watch_count_.load(std::memory_order_relaxed);
+    stats.events = events_.load(std::memory_order_relaxed);
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.overflows = overflows_.load(std::memory_order_relaxed);
+    stats.watch_failures = watch_failures_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void LibraryWatcher::flush() {
+    if (pending_.empty()) {
+        return;
+    }
+
+    std::vector<std::string> changed(pending_.begin(), pending_.end());
+    pending_.clear();
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    Logger::debug("Library changed: " + std::to_string(changed.size()) + " paths");
+
+    try {
+        callback_(changed);
+    } catch (const std::exception& e) {
+        Logger::error("Failed to apply library changes: " + std::string(e.what()));
+    }
+}
+
+#ifdef __linux__
+
+namespace {
+
+constexpr uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                IN_CLOSE_WRITE | IN_DELETE_SELF | IN_ONLYDIR;
+
+} // namespace
+
+bool LibraryWatcher::start() {
+    if (thread_.joinable()) {
+        return true;
+    }
+
+    inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (inotify_fd_ < 0 || wake_fd_ < 0) {
+        Logger::warning("inotify unavailable, library changes need a restart: " +
+                        std::string(std::strerror(errno)));
+        stop();
+        return false;
+    }
+
+    addWatches(root_path_, 0);
+    Logger::info("Watching " + std::to_string(watch_count_.load()) + " library directories for changes");
+
+    thread_ = std::thread([this]() { run(); });
+    return true;
+}
+
+void LibraryWatcher::stop() {
+    if (thread_.joinable()) {
+        uint64_t one = 1;
+        ssize_t written = ::write(wake_fd_, &one, sizeof(one));
+        (void)written;
+        thread_.join();
+    }
+    if (inotify_fd_ >= 0) {
+        ::close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+    if (wake_fd_ >= 0) {
+        ::close(wake_fd_);
+        wake_fd_ = -1;
+    }
+    watches_.clear();
+    watch_count_ = 0;
+}
+
+void LibraryWatcher::addWatches(const std::string& path, int depth) {
+    int wd = ::inotify_add_watch(inotify_fd_, path.c_str(), WATCH_MASK);
+    if (wd < 0) {
+        // ENOSPC means fs.inotify.max_user_watches is too low for the tree
+        if (watch_failures_.fetch_add(1, std::memory_order_relaxed) == 0) {
+            Logger::warning("Cannot watch " + path + ": " + std::strerror(errno));
+        }
+        return;
+    }
+    if (watches_.emplace(wd, Watch{path, depth}).second) {
+        watch_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Listed after the watch is in place, so a directory created meanwhile
+    // shows up either here or as an event
+    if (depth < MAX_WATCH_DEPTH) {
+        for (const auto& entry : FileUtils::readDirectory(path, nullptr, nullptr)) {
+            if (entry.type == DirectoryEntry::Type::DIRECTORY) {
+                addWatches(path + "/" + entry.name, depth + 1);
+            }
+        }
+    }
+}
+
+void LibraryWatcher::removeWatches(const std::string& path) {
+    // A renamed directory keeps its watches under the old path; drop them
+    // and watch it again under the new one
+    for (auto it = watches_.begin(); it != watches_.end();) {
+        const std::string& watched = it->second.path;
+        if (watched == path || (watched.compare(0, path.length(), path) == 0 && watched[path.length()] == '/')) {
+            ::inotify_rm_watch(inotify_fd_, it->first);
+            it = watches_.erase(it);
+            watch_count_.fetch_sub(1, std::memory_order_relaxed);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void LibraryWatcher::run() {
+    alignas(struct inotify_event) char buffer[64 * 1024];
+    Clock::time_point first_event;
+    Clock::time_point last_event;
+
+    while (true) {
+        int timeout = -1;
+        if (!pending_.empty()) {
+            auto deadline = std::min(last_event + coalesce_delay_, first_event + max_delay_);
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+            timeout = static_cast<int>(std::max<std::chrono::milliseconds::rep>(0, remaining.count()));
+        }
+
+        pollfd fds[2] = {{inotify_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+        int ready = ::poll(fds, 2, timeout);
+        if (ready < 0 && errno != EINTR) {
+            Logger::error("Library watcher stopped: " + std::string(std::strerror(errno)));
+            return;
+        }
+        if (ready > 0 && (fds[1].revents & POLLIN)) {
+            return;
+        }
+
+        if (ready > 0 && (fds[0].revents & POLLIN)) {
+            bool had_pending = !pending_.empty();
+            ssize_t length;
+            while ((length = ::read(inotify_fd_, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + length;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(p);
+                    p += sizeof(inotify_event) + event->len;
+                    events_.fetch_add(1, std::memory_order_relaxed);
+
+                    if (event->mask & IN_Q_OVERFLOW) {
+                        // Events were lost; only a full rescan is safe
+                        overflows_.fetch_add(1, std::memory_order_relaxed);
+                        pending_.insert(root_path_);
+                        continue;
+                    }
+
+                    auto it = watches_.find(event->wd);
+                    if (it == watches_.end()) {
+                        continue;
+                    }
+                    if (event->mask & IN_IGNORED) {
+                        watches_.erase(it);
+                        watch_count_.fetch_sub(1, std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    Watch watch = it->second;
+                    std::string path = watch.path;
+                    if (event->len > 0) {
+                        path += "/";
+                        path += event->name;
+                    }
+
+                    if (event->mask & IN_ISDIR) {
+                        if (event->mask & IN_MOVED_FROM) {
+                            removeWatches(path);
+                        } else if ((event->mask & (IN_CREATE | IN_MOVED_TO)) && watch.depth < MAX_WATCH_DEPTH) {
+                            addWatches(path, watch.depth + 1);
+                        }
+                    }
+                    pending_.insert(path);
+                }
+            }
+
+            auto now = Clock::now();
+            if (!had_pending && !pending_.empty()) {
+                first_event = now;
+            }
+            last_event = now;
+        }
+
+        if (!pending_.empty()) {
+            auto now = Clock::now();
+            if (now >= last_event + coalesce_delay_ || now >= first_event + max_delay_) {
+                flush();
+            }
+        }
+    }
+}
+
+#else
+
+bool LibraryWatcher::start() {
+    Logger::warning("Library watching needs inotify; changes are picked up on restart");
+    return false;
+}
+
+void LibraryWatcher::stop() {
+}
+
+void LibraryWatcher::addWatches(const std::string&, int) {
+}
+
+void LibraryWatcher::removeWatches(const std::string&) {
+}
+
+void LibraryWatcher::run() {
+}
+
+#endif
+
+} // namespace utec
@@ -0,0 +1,74 @@
+// src/filesystem/library_watcher.h
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace utec {
+
+    // Watches the year, semester and course directories with inotify and
+    // reports the paths that changed underneath them. Changes are collected
+    // until the tree has been quiet for coalesce_delay, or max_delay after the
+    // first one, so copying a batch of lectures causes a single callback.
+    class LibraryWatcher {
+    public:
+        struct Stats {
+            uint64_t watches = 0;
+            uint64_t events = 0;
+            uint64_t batches = 0;
+            uint64_t overflows = 0;       // kernel queue overflowed, the whole tree was reported
+            uint64_t watch_failures = 0;
+        };
+
+        using ChangeCallback = std::function<void(const std::vector<std::string>& changed_paths)>;
+
+        LibraryWatcher(const std::string& root_path, std::chrono::milliseconds coalesce_delay,
+                       std::chrono::milliseconds max_delay, ChangeCallback callback);
+        ~LibraryWatcher();
+
+        LibraryWatcher(const LibraryWatcher&) = delete;
+        LibraryWatcher& operator=(const LibraryWatcher&) = delete;
+
+        // False when inotify is unavailable; changes are then only seen on restart
+        bool start();
+        void stop();
+        Stats stats() const;
+
+    private:
+        struct Watch {
+            std::string path;
+            int depth;  // 0 = root, 3 = course
+        };
+
+        std::string root_path_;
+        std::chrono::milliseconds coalesce_delay_;
+        std::chrono::milliseconds max_delay_;
+        ChangeCallback callback_;
+
+        int inotify_fd_ = -1;
+        int wake_fd_ = -1;
+        std::thread thread_;
+
+        // Owned by the watcher thread once it is started
+        std::unordered_map<int, Watch> watches_;
+        std::set<std::string> pending_;
+
+        std::atomic<uint64_t> watch_count_{0};
+        std::atomic<uint64_t> events_{0};
+        std::atomic<uint64_t> batches_{0};
+        std::atomic<uint64_t> overflows_{0};
+        std::atomic<uint64_t> watch_failures_{0};
+
+        void run();
+        void addWatches(const std::string& path, int depth);
+        void removeWatches(const std::string& path);
+        void flush();
+    };
+
+} // namespace utec
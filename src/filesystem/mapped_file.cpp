@@ -0,0 +1,103 @@
+// src/filesystem/mapped_file.cpp
+#include "filesystem/mapped_file.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utec {
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string& path) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+
+#ifdef _WIN32
+    HANDLE handle = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                  nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    file->file_handle_ = handle;
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(handle, &size) || size.QuadPart <= 0) {
+        return nullptr;
+    }
+
+    HANDLE mapping = ::CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        return nullptr;
+    }
+    file->mapping_handle_ = mapping;
+
+    void* addr = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (addr == nullptr) {
+        return nullptr;
+    }
+
+    file->data_ = static_cast<const char*>(addr);
+    file->size_ = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    // The mapping keeps its own reference to the file
+    file = fromDescriptor(fd, static_cast<size_t>(st.st_size));
+    ::close(fd);
+#endif
+
+    return file;
+}
+
+#ifndef _WIN32
+std::shared_ptr<MappedFile> MappedFile::fromDescriptor(int fd, size_t size) {
+    if (fd < 0 || size == 0) {
+        return nullptr;
+    }
+
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    file->data_ = static_cast<const char*>(addr);
+    file->size_ = size;
+    return file;
+}
+#endif
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+    if (data_) {
+        ::UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_) {
+        ::CloseHandle(static_cast<HANDLE>(mapping_handle_));
+    }
+    if (file_handle_) {
+        ::CloseHandle(static_cast<HANDLE>(file_handle_));
+    }
+#else
+    if (data_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+}
+
+} // namespace utec
@@ -0,0 +1,37 @@
+// src/filesystem/mapped_file.h
+#pragma once
+#include <string>
+#include <memory>
+#include <cstddef>
+
+namespace utec {
+
+    // Read-only memory mapping of a whole file. Bytes are served straight from
+    // the page cache, so streaming a range never copies it into the heap.
+    class MappedFile {
+    public:
+        static std::shared_ptr<MappedFile> open(const std::string& path);
+#ifndef _WIN32
+        // Maps an already open descriptor; the caller keeps ownership of fd
+        static std::shared_ptr<MappedFile> fromDescriptor(int fd, size_t size);
+#endif
+
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data() const { return data_; }
+        size_t size() const { return size_; }
+
+    private:
+        MappedFile() = default;
+
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+#ifdef _WIN32
+        void* file_handle_ = nullptr;
+        void* mapping_handle_ = nullptr;
+#endif
+    };
+
+} // namespace utec
@@ -0,0 +1,198 @@
+// src/filesystem/read_ahead.cpp
+#include "filesystem/read_ahead.h"
+#include "filesystem/file_handle_cache.h"
+#include <algorithm>
+#include <fcntl.h>
+
+namespace utec {
+
+ReadAheadSession::ReadAheadSession(ReadAheadTracker& tracker, std::shared_ptr<FileHandle> file)
+    : tracker_(tracker), file_(std::move(file)) {
+}
+
+void ReadAheadSession::onRead(uint64_t offset, size_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_used_.store(ReadAheadTracker::nowSeconds(), std::memory_order_relaxed);
+
+    // Multipart responses jump forward a little between parts; anything
+    // outside the prefetched run is a real seek
+    if (offset < run_start_ || offset > advised_end_ + window_) {
+        seekTo(offset);
+    }
+
+    uint64_t end = offset + length;
+    next_offset_.store(end, std::memory_order_relaxed);
+
+    if (!sequential_hint_ && end - run_start_ >= 2 * tracker_.min_window_) {
+        ReadAheadTracker::sequential(*file_);
+        sequential_hint_ = true;
+    }
+
+    // Prefetch the next window once playback is half way through the current one
+    if (end + window_ / 2 >= advised_end_) {
+        uint64_t start = std::max(advised_end_, end);
+        if (start < file_->size()) {
+            uint64_t prefetch = std::min<uint64_t>(window_, file_->size() - start);
+            tracker_.willNeed(*file_, start, prefetch);
+            advised_end_ = start + prefetch;
+        }
+        window_ = std::min(window_ * 2, tracker_.max_window_);
+    }
+}
+
+void ReadAheadSession::restart(uint64_t offset) {
+    run_start_ = offset;
+    advised_end_ = offset;
+    window_ = tracker_.min_window_;
+    sequential_hint_ = false;
+    next_offset_.store(offset, std::memory_order_relaxed);
+}
+
+void ReadAheadSession::seekTo(uint64_t offset) {
+    tracker_.seeks_.fetch_add(1, std::memory_order_relaxed);
+
+    // The page cache is shared: only drop what no other viewer is still playing
+    uint64_t played_end = next_offset_.load(std::memory_order_relaxed);
+    if (played_end > run_start_ && !tracker_.isPlayedByOthers(*this, run_start_, played_end)) {
+        tracker_.dontNeed(*file_, run_start_, played_end - run_start_);
+    }
+
+    restart(offset);
+}
+
+ReadAheadTracker::ReadAheadTracker(size_t min_window, size_t max_window, size_t max_sessions,
+                                   std::chrono::seconds idle_timeout)
+    : min_window_(min_window), max_window_(std::max(min_window, max_window)),
+      max_sessions_(std::max<size_t>(1, max_sessions)), idle_timeout_(idle_timeout) {
+}
+
+std::shared_ptr<ReadAheadSession> ReadAheadTracker::begin(const std::string& client,
+                                                          std::shared_ptr<FileHandle> file,
+                                                          uint64_t offset) {
+    int64_t now = nowSeconds();
+    std::string key = client + "|" + std::to_string(file->device()) + ":" + std::to_string(file->inode());
+
+    std::shared_ptr<ReadAheadSession> session;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sessions_.size() >= max_sessions_) {
+            prune(now);
+        }
+
+        auto& slot = sessions_[key];
+        // A reopened file (new mtime or size) starts a fresh session
+        if (!slot || slot->file_ != file) {
+            slot = std::make_shared<ReadAheadSession>(*this, file);
+        }
+        session = slot;
+    }
+
+    std::lock_guard<std::mutex> lock(session->mutex_);
+    session->last_used_.store(now, std::memory_order_relaxed);
+
+    if (!session->started_) {
+        session->started_ = true;
+        session->restart(offset);
+        return session;
+    }
+
+    uint64_t expected = session->next_offset_.load(std::memory_order_relaxed);
+    if (offset + min_window_ >= expected && offset <= expected + session->window_) {
+        sequential_requests_.fetch_add(1, std::memory_order_relaxed);
+        session->next_offset_.store(offset, std::memory_order_relaxed);
+    } else {
+        session->seekTo(offset);
+    }
+
+    return session;
+}
+
+ReadAheadTracker::Stats ReadAheadTracker::stats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.sessions = sessions_.size();
+    }
+    stats.sequential_requests = sequential_requests_.load(std::memory_order_relaxed);
+    stats.seeks = seeks_.load(std::memory_order_relaxed);
+    stats.willneed_bytes = willneed_bytes_.load(std::memory_order_relaxed);
+    stats.dontneed_bytes = dontneed_bytes_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void ReadAheadTracker::prune(int64_t now) {
+    int64_t idle_limit = now - static_cast<int64_t>(idle_timeout_.count());
+    for (auto it = sessions_.begin(); it != sessions_.end();) {
+        if (it->second->last_used_.load(std::memory_order_relaxed) < idle_limit) {
+            it = sessions_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    while (sessions_.size() >= max_sessions_) {
+        auto oldest = std::min_element(sessions_.begin(), sessions_.end(),
+            [](const auto& a, const auto& b) {
+                return a.second->last_used_.load(std::memory_order_relaxed) <
+                       b.second->last_used_.load(std::memory_order_relaxed);
+            });
+        sessions_.erase(oldest);
+    }
+}
+
+bool ReadAheadTracker::isPlayedByOthers(const ReadAheadSession& self, uint64_t start, uint64_t end) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t idle_limit = nowSeconds() - static_cast<int64_t>(idle_timeout_.count());
+
+    for (const auto& [key, session] : sessions_) {
+        if (session.get() == &self || session->file_->inode() != self.file_->inode() ||
+            session->file_->device() != self.file_->device() ||
+            session->last_used_.load(std::memory_order_relaxed) < idle_limit) {
+            continue;
+        }
+
+        // A viewer inside the region, or about to enter it, still needs these pages
+        uint64_t position = session->next_offset_.load(std::memory_order_relaxed);
+        if (position + max_window_ >= start && position < end + max_window_) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReadAheadTracker::willNeed(const FileHandle& file, uint64_t offset, uint64_t length) {
+#ifdef POSIX_FADV_WILLNEED
+    if (::posix_fadvise(file.descriptor(), static_cast<off_t>(offset), static_cast<off_t>(length),
+                        POSIX_FADV_WILLNEED) == 0) {
+        willneed_bytes_.fetch_add(length, std::memory_order_relaxed);
+    }
+#else
+    (void)file; (void)offset; (void)length;
+#endif
+}
+
+void ReadAheadTracker::dontNeed(const FileHandle& file, uint64_t offset, uint64_t length) {
+#ifdef POSIX_FADV_DONTNEED
+    if (::posix_fadvise(file.descriptor(), static_cast<off_t>(offset), static_cast<off_t>(length),
+                        POSIX_FADV_DONTNEED) == 0) {
+        dontneed_bytes_.fetch_add(length, std::memory_order_relaxed);
+    }
+#else
+    (void)file; (void)offset; (void)length;
+#endif
+}
+
+void ReadAheadTracker::sequential(const FileHandle& file) {
+#ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise(file.descriptor(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#else
+    (void)file;
+#endif
+}
+
+int64_t ReadAheadTracker::nowSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace utec
@@ -0,0 +1,87 @@
+// src/filesystem/read_ahead.h
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace utec {
+
+    class FileHandle;
+    class ReadAheadTracker;
+
+    // One viewer watching one file, kept across the many range requests a
+    // player sends. Sequential playback grows the prefetch window; a seek
+    // shrinks it and releases the pages that were already played.
+    class ReadAheadSession {
+    public:
+        ReadAheadSession(ReadAheadTracker& tracker, std::shared_ptr<FileHandle> file);
+
+        // Called before each chunk of a response is read
+        void onRead(uint64_t offset, size_t length);
+
+    private:
+        friend class ReadAheadTracker;
+
+        ReadAheadTracker& tracker_;
+        std::shared_ptr<FileHandle> file_;
+        std::mutex mutex_;
+        bool started_ = false;
+        bool sequential_hint_ = false;
+        uint64_t run_start_ = 0;
+        uint64_t advised_end_ = 0;
+        size_t window_ = 0;
+        std::atomic<uint64_t> next_offset_{0};
+        std::atomic<int64_t> last_used_{0};
+
+        void restart(uint64_t offset);
+        void seekTo(uint64_t offset);
+    };
+
+    class ReadAheadTracker {
+    public:
+        struct Stats {
+            uint64_t sessions = 0;
+            uint64_t sequential_requests = 0;
+            uint64_t seeks = 0;
+            uint64_t willneed_bytes = 0;
+            uint64_t dontneed_bytes = 0;
+        };
+
+        ReadAheadTracker(size_t min_window, size_t max_window, size_t max_sessions,
+                         std::chrono::seconds idle_timeout);
+
+        // Classifies a new response for this client as a continuation or a seek
+        std::shared_ptr<ReadAheadSession> begin(const std::string& client,
+                                                std::shared_ptr<FileHandle> file, uint64_t offset);
+        Stats stats() const;
+
+    private:
+        friend class ReadAheadSession;
+
+        size_t min_window_;
+        size_t max_window_;
+        size_t max_sessions_;
+        std::chrono::seconds idle_timeout_;
+
+        mutable std::mutex mutex_;
+        std::unordered_map<std::string, std::shared_ptr<ReadAheadSession>> sessions_;
+
+        std::atomic<uint64_t> sequential_requests_{0};
+        std::atomic<uint64_t> seeks_{0};
+        std::atomic<uint64_t> willneed_bytes_{0};
+        std::atomic<uint64_t> dontneed_bytes_{0};
+
+        void prune(int64_t now);
+        bool isPlayedByOthers(const ReadAheadSession& self, uint64_t start, uint64_t end) const;
+        void willNeed(const FileHandle& file, uint64_t offset, uint64_t length);
+        void dontNeed(const FileHandle& file, uint64_t offset, uint64_t length);
+        static void sequential(const FileHandle& file);
+        static int64_t nowSeconds();
+    };
+
+} // namespace utec
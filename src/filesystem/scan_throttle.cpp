@@ -0,0 +1,164 @@
+// src/filesystem/scan_throttle.cpp
+#include "filesystem/scan_throttle.h"
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace utec {
+
+namespace {
+
+// Up to a second's worth of operations may run back to back after a pause
+constexpr auto BURST_WINDOW = std::chrono::seconds(1);
+
+// Slow reads only count while streams are still reading
+constexpr auto LATENCY_MAX_AGE = std::chrono::seconds(1);
+
+// An operation waits at most this long for the streams, so a busy server
+// slows the scan down without stopping it
+constexpr auto BACKOFF_STEP = std::chrono::milliseconds(50);
+constexpr auto BACKOFF_MAX = std::chrono::seconds(1);
+
+#ifdef __linux__
+// From linux/ioprio.h, which older kernel headers lack
+constexpr int IOPRIO_WHO_PROCESS = 1;
+constexpr int IOPRIO_CLASS_SHIFT = 13;
+constexpr int IOPRIO_CLASS_IDLE = 3;
+#endif
+
+} // namespace
+
+ScanThrottle::ScanThrottle(uint64_t ops_per_second, std::chrono::milliseconds backoff_latency,
+                           bool idle_io_priority)
+    : budget_(ops_per_second), backoff_latency_(backoff_latency), idle_io_priority_(idle_io_priority),
+      next_slot_(Clock::now()), window_start_(Clock::now()) {
+}
+
+void ScanThrottle::acquire(Op op) {
+    auto now = Clock::now();
+    Clock::time_point slot = now;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++ops_;
+        if (op == Op::LIST) {
+            ++listed_;
+        }
+        if (now - window_start_ >= std::chrono::seconds(1)) {
+            last_rate_ = window_ops_;
+            window_ops_ = 0;
+            window_start_ = now;
+        }
+        ++window_ops_;
+
+        if (budget_ > 0) {
+            // Each operation takes the next free slot; slots left unused
+            // while idle are only kept for one burst window
+            auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / budget_;
+            next_slot_ = std::max(next_slot_, now - std::chrono::duration_cast<Clock::duration>(BURST_WINDOW));
+            slot = next_slot_;
+            next_slot_ += interval;
+        }
+    }
+
+    if (slot > now) {
+        std::this_thread::sleep_until(slot);
+        paused_us_ += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(slot - now).count());
+        now = Clock::now();
+    }
+
+    if (backoff_latency_.count() > 0 && streamsSlow(now)) {
+        ++backoffs_;
+        auto start = now;
+        while (streamsSlow(now) && now - start < BACKOFF_MAX) {
+            std::this_thread::sleep_for(BACKOFF_STEP);
+            now = Clock::now();
+        }
+        paused_us_ += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - start).count());
+    }
+}
+
+void ScanThrottle::recordStreamRead(std::chrono::steady_clock::duration latency) {
+    auto sample = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+
+    // An exponential moving average over roughly the last eight reads;
+    // concurrent updates may drop a sample, which the average absorbs
+    uint64_t average = latency_average_us_.load(std::memory_order_relaxed);
+    latency_average_us_.store(average - average / 8 + sample / 8, std::memory_order_relaxed);
+    last_read_ns_.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    stream_reads_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool ScanThrottle::streamsSlow(Clock::time_point now) const {
+    auto last_read = Clock::time_point(Clock::duration(last_read_ns_.load(std::memory_order_relaxed)));
+    return now - last_read < LATENCY_MAX_AGE &&
+           latency_average_us_.load(std::memory_order_relaxed) > static_cast<uint64_t>(backoff_latency_.count());
+}
+
+void ScanThrottle::beginScan() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++running_scans_;
+    scan_start_listed_ = listed_;
+}
+
+void ScanThrottle::endScan() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --running_scans_;
+    scan_directories_ = listed_ - scan_start_listed_;
+    expected_directories_ = scan_directories_;
+}
+
+ScanThrottle::Stats ScanThrottle::stats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.ops = ops_;
+        // The last full window, unless scanning stopped since
+        stats.ops_per_second = Clock::now() - window_start_ < std::chrono::seconds(2) ? last_rate_ : 0;
+        stats.running_scans = running_scans_;
+        stats.scan_directories = running_scans_ ? listed_ - scan_start_listed_ : scan_directories_;
+        stats.expected_directories = expected_directories_;
+    }
+    stats.budget = budget_;
+    stats.paused_us = paused_us_.load();
+    stats.backoffs = backoffs_.load();
+    stats.stream_reads = stream_reads_.load();
+    stats.stream_read_latency_us = latency_average_us_.load();
+    return stats;
+}
+
+IdleIoPriority::IdleIoPriority(const ScanThrottle* throttle) {
+#ifdef __linux__
+    if (!throttle || !throttle->idleIoPriority()) {
+        return;
+    }
+    // Per thread: the thread id stands for the process id here
+    auto tid = static_cast<int>(::syscall(SYS_gettid));
+    int current = static_cast<int>(::syscall(SYS_ioprio_get, IOPRIO_WHO_PROCESS, tid));
+    if (current >= 0 &&
+        ::syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT) == 0) {
+        previous_ = current;
+    }
+#else
+    (void)throttle;
+#endif
+}
+
+IdleIoPriority::~IdleIoPriority() {
+#ifdef __linux__
+    if (previous_ >= 0) {
+        auto tid = static_cast<int>(::syscall(SYS_gettid));
+        // Older kernels report the default class with data they refuse to take back
+        if (::syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, previous_) != 0) {
+            ::syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, 0);
+        }
+    }
+#endif
+}
+
+} // namespace utec
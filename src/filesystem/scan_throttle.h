@@ -0,0 +1,92 @@
+// src/filesystem/scan_throttle.h
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace utec {
+
+    // Paces the directory scans so they do not take the disk away from the
+    // streams: every open and stat of a scan waits for a slot in an ops per
+    // second budget, and scans pause while stream reads are slow. Streams
+    // report how long their reads take.
+    class ScanThrottle {
+    public:
+        enum class Op { LIST, STAT };
+
+        struct Stats {
+            uint64_t ops = 0;
+            uint64_t ops_per_second = 0;          // measured over the last full second
+            uint64_t budget = 0;                  // ops per second, 0 = unlimited
+            uint64_t paused_us = 0;               // waiting for the budget or for the streams
+            uint64_t backoffs = 0;                // ops delayed by slow stream reads
+            uint64_t stream_reads = 0;
+            uint64_t stream_read_latency_us = 0;  // moving average
+            uint64_t running_scans = 0;           // full library scans
+            uint64_t scan_directories = 0;        // listed by the current or last full scan
+            uint64_t expected_directories = 0;    // listed by the full scan before it
+        };
+
+        // backoff_latency = 0 disables the backoff
+        ScanThrottle(uint64_t ops_per_second, std::chrono::milliseconds backoff_latency, bool idle_io_priority);
+
+        ScanThrottle(const ScanThrottle&) = delete;
+        ScanThrottle& operator=(const ScanThrottle&) = delete;
+
+        // Blocks the scanning thread until the operation may go ahead
+        void acquire(Op op);
+        void recordStreamRead(std::chrono::steady_clock::duration latency);
+
+        // Brackets a full library scan, for the progress metrics
+        void beginScan();
+        void endScan();
+
+        bool idleIoPriority() const { return idle_io_priority_; }
+        Stats stats() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        const uint64_t budget_;
+        const std::chrono::microseconds backoff_latency_;
+        const bool idle_io_priority_;
+
+        mutable std::mutex mutex_;
+        Clock::time_point next_slot_;
+        Clock::time_point window_start_;
+        uint64_t window_ops_ = 0;
+        uint64_t last_rate_ = 0;
+        uint64_t ops_ = 0;
+        uint64_t listed_ = 0;
+        uint64_t scan_start_listed_ = 0;
+        uint64_t scan_directories_ = 0;
+        uint64_t expected_directories_ = 0;
+        uint64_t running_scans_ = 0;
+
+        std::atomic<uint64_t> paused_us_{0};
+        std::atomic<uint64_t> backoffs_{0};
+        std::atomic<uint64_t> stream_reads_{0};
+        std::atomic<uint64_t> latency_average_us_{0};
+        std::atomic<int64_t> last_read_ns_{0};  // steady clock
+
+        bool streamsSlow(Clock::time_point now) const;
+    };
+
+    // Puts the calling thread in the idle I/O class until it goes out of
+    // scope; the BFQ and CFQ schedulers then serve its reads only when no
+    // other process is waiting for the disk. Does nothing without a throttle
+    // or when the throttle leaves the priority alone.
+    class IdleIoPriority {
+    public:
+        explicit IdleIoPriority(const ScanThrottle* throttle);
+        ~IdleIoPriority();
+
+        IdleIoPriority(const IdleIoPriority&) = delete;
+        IdleIoPriority& operator=(const IdleIoPriority&) = delete;
+
+    private:
+        int previous_ = -1;
+    };
+
+} // namespace utec
@@ -0,0 +1,141 @@
+// src/server/admission_controller.cpp
+#include "server/admission_controller.h"
+#include "utils/logger.h"
+#include "httplib.h"
+
+namespace utec {
+
+namespace {
+
+// Set on the threads of the shedding pool
+thread_local bool shedding_thread = false;
+
+} // namespace
+
+// Hands connections to the regular workers, and to the shedding pool once
+// their queue is full. httplib itself would close the socket without a word.
+class AdmissionTaskQueue : public httplib::TaskQueue {
+public:
+    AdmissionTaskQueue(AdmissionController& controller, size_t worker_threads, size_t max_queued,
+                       size_t shed_threads)
+        : controller_(controller), workers_(worker_threads, max_queued),
+          shedders_(shed_threads, shed_threads * 16) {
+    }
+
+    bool enqueue(std::function<void()> fn) override {
+        auto& busy = controller_.busy_workers_;
+        if (workers_.enqueue([fn, &busy]() {
+                busy.fetch_add(1, std::memory_order_relaxed);
+                fn();
+                busy.fetch_sub(1, std::memory_order_relaxed);
+            })) {
+            return true;
+        }
+
+        controller_.shed_connections_.fetch_add(1, std::memory_order_relaxed);
+        bool queued = shedders_.enqueue([fn = std::move(fn)]() {
+            shedding_thread = true;
+            fn();
+            shedding_thread = false;
+        });
+        if (!queued) {
+            controller_.dropped_connections_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return queued;
+    }
+
+    void shutdown() override {
+        workers_.shutdown();
+        shedders_.shutdown();
+    }
+
+private:
+    AdmissionController& controller_;
+    httplib::ThreadPool workers_;
+    httplib::ThreadPool shedders_;
+};
+
+AdmissionController::StreamSlot::~StreamSlot() {
+    controller_.active_streams_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+AdmissionController::AdmissionController(size_t max_streams, size_t reserved_workers, int retry_after_seconds)
+    : max_streams_(max_streams), reserved_workers_(reserved_workers), retry_after_seconds_(retry_after_seconds) {
+}
+
+std::shared_ptr<AdmissionController::StreamSlot> AdmissionController::admitStream() {
+    uint64_t active = active_streams_.load(std::memory_order_relaxed);
+    do {
+        if (active >= max_streams_) {
+            rejected_streams_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    } while (!active_streams_.compare_exchange_weak(active, active + 1, std::memory_order_relaxed));
+
+    return std::make_shared<StreamSlot>(*this);
+}
+
+bool AdmissionController::shedIfOverloaded(const httplib::Request& req, httplib::Response& res) {
+    if (!shedding_thread || isReserved(req.path)) {
+        return false;
+    }
+
+    shed_requests_.fetch_add(1, std::memory_order_relaxed);
+    // Ask the client to go away rather than send its next request here.
+    // httplib decides whether to close from the request, before routing, so
+    // the response says it; a client that honours it closes the socket and
+    // frees the shedding thread instead of waiting out the keep-alive
+    res.set_header("Connection", "close");
+    reject(res);
+    return true;
+}
+
+void AdmissionController::limitKeepAlive(const httplib::Request& req, httplib::Response& res) {
+    // A stream's slot is released with the response, but its worker would
+    // stay on the idle connection; other paths keep their connections while
+    // the reserve is untouched. The count includes this connection
+    bool close = shedding_thread || !isReserved(req.path) ||
+                 busy_workers_.load(std::memory_order_relaxed) + reserved_workers_ >= worker_threads_;
+    if (close && res.get_header_value("Connection") != "close") {
+        res.set_header("Connection", "close");
+        closed_keep_alives_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // httplib adds Keep-Alive to every response it does not close itself,
+    // which would contradict Connection: close
+    if (res.get_header_value("Connection") == "close") {
+        res.headers.erase("Keep-Alive");
+    }
+}
+
+void AdmissionController::reject(httplib::Response& res) const {
+    res.status = 503;
+    res.set_header("Retry-After", std::to_string(retry_after_seconds_));
+    res.set_content("Server busy, retry later", "text/plain");
+}
+
+httplib::TaskQueue* AdmissionController::createTaskQueue(size_t worker_threads, size_t max_queued,
+                                                         size_t shed_threads) {
+    worker_threads_ = worker_threads;
+    return new AdmissionTaskQueue(*this, worker_threads, max_queued, shed_threads);
+}
+
+bool AdmissionController::isReserved(const std::string& path) {
+    return path == "/" || path == "/favicon.ico" ||
+           path.compare(0, 5, "/api/") == 0 || path.compare(0, 8, "/static/") == 0;
+}
+
+AdmissionController::Stats AdmissionController::stats() const {
+    Stats stats;
+    stats.active_streams = active_streams_.load(std::memory_order_relaxed);
+    stats.max_streams = max_streams_;
+    stats.rejected_streams = rejected_streams_.load(std::memory_order_relaxed);
+    stats.shed_connections = shed_connections_.load(std::memory_order_relaxed);
+    stats.shed_requests = shed_requests_.load(std::memory_order_relaxed);
+    stats.dropped_connections = dropped_connections_.load(std::memory_order_relaxed);
+    stats.busy_workers = busy_workers_.load(std::memory_order_relaxed);
+    stats.closed_keep_alives = closed_keep_alives_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace utec
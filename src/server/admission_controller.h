@@ -0,0 +1,87 @@
+// src/server/admission_controller.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Forward declaration for httplib
+namespace httplib {
+    class Request;
+    class Response;
+    class TaskQueue;
+}
+
+namespace utec {
+
+    // Decides which requests the server takes on when it is busy. Streams hold
+    // a worker for the whole transfer, so they are limited to the workers left
+    // after the API reserve. Connections that arrive while the worker queue is
+    // full go to a small shedding pool that still serves the API and the index
+    // page, and answers everything else with 503 and Retry-After. httplib
+    // keeps a worker on a connection until its keep-alive runs out, so
+    // clients are asked to close after a stream, and after any response
+    // while the free workers are down to the reserve.
+    class AdmissionController {
+    public:
+        struct Stats {
+            uint64_t active_streams = 0;
+            uint64_t max_streams = 0;
+            uint64_t rejected_streams = 0;
+            uint64_t shed_connections = 0;
+            uint64_t shed_requests = 0;
+            uint64_t dropped_connections = 0;
+            uint64_t busy_workers = 0;
+            uint64_t closed_keep_alives = 0;
+        };
+
+        // Held for as long as a stream response is being written
+        class StreamSlot {
+        public:
+            explicit StreamSlot(AdmissionController& controller) : controller_(controller) {}
+            ~StreamSlot();
+
+        private:
+            AdmissionController& controller_;
+        };
+
+        AdmissionController(size_t max_streams, size_t reserved_workers, int retry_after_seconds);
+
+        // Empty when the stream limit is reached
+        std::shared_ptr<StreamSlot> admitStream();
+
+        // Pre-routing check; true when the request was answered with 503
+        bool shedIfOverloaded(const httplib::Request& req, httplib::Response& res);
+        void reject(httplib::Response& res) const;
+
+        // Post-routing: adds Connection: close when the worker should be
+        // given back once the response is sent
+        void limitKeepAlive(const httplib::Request& req, httplib::Response& res);
+
+        // Worker pool for httplib::Server::new_task_queue
+        httplib::TaskQueue* createTaskQueue(size_t worker_threads, size_t max_queued,
+                                            size_t shed_threads);
+
+        static bool isReserved(const std::string& path);
+        Stats stats() const;
+
+    private:
+        friend class AdmissionTaskQueue;
+
+        size_t max_streams_;
+        size_t reserved_workers_;
+        size_t worker_threads_ = 0;  // set by createTaskQueue
+        int retry_after_seconds_;
+
+        std::atomic<uint64_t> busy_workers_{0};  // connections held by the regular workers
+        std::atomic<uint64_t> closed_keep_alives_{0};
+
+        std::atomic<uint64_t> active_streams_{0};
+        std::atomic<uint64_t> rejected_streams_{0};
+        std::atomic<uint64_t> shed_connections_{0};
+        std::atomic<uint64_t> shed_requests_{0};
+        std::atomic<uint64_t> dropped_connections_{0};
+    };
+
+} // namespace utec
@@ -0,0 +1,146 @@
+// src/server/bandwidth_scheduler.cpp
+#include "server/bandwidth_scheduler.h"
+#include <algorithm>
+#include <limits>
+
+namespace utec {
+
+namespace {
+
+// A stream that has not asked for bandwidth this recently is paused or
+// stalled on its client, and leaves its share to the others
+constexpr auto ACTIVE_WINDOW = std::chrono::seconds(1);
+constexpr auto RECOUNT_INTERVAL = std::chrono::milliseconds(100);
+constexpr auto MAX_WAIT = std::chrono::milliseconds(100);
+
+double secondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double>(to - from).count();
+}
+
+} // namespace
+
+BandwidthScheduler::Stream::~Stream() {
+    if (scheduler_) {
+        scheduler_->close(*this);
+    }
+}
+
+void BandwidthScheduler::Stream::pace(size_t size) {
+    scheduler_->pace(*this, size);
+}
+
+BandwidthScheduler::BandwidthScheduler(uint64_t total_rate, uint64_t stream_cap, size_t burst)
+    : total_rate_(total_rate), stream_cap_(stream_cap), burst_(static_cast<double>(std::max<size_t>(1, burst))),
+      tokens_(burst_), last_refill_(Clock::now()), last_count_(last_refill_) {
+}
+
+std::shared_ptr<BandwidthScheduler::Stream> BandwidthScheduler::open() {
+    auto stream = std::make_shared<Stream>();
+    stream->scheduler_ = shared_from_this();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // New streams start with a full bucket so playback begins without delay
+    stream->tokens_ = burst_;
+    stream->last_refill_ = stream->last_active_ = Clock::now();
+    stream->position_ = streams_.insert(streams_.end(), stream.get());
+    return stream;
+}
+
+BandwidthScheduler::Stats BandwidthScheduler::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.open_streams = streams_.size();
+    stats.active_streams = active_streams_;
+    if (total_rate_ > 0 || stream_cap_ > 0) {
+        uint64_t share = total_rate_ > 0 ? total_rate_ / std::max<size_t>(1, active_streams_)
+                                         : stream_cap_;
+        stats.fair_share_rate = stream_cap_ > 0 ? std::min(share, stream_cap_) : share;
+    }
+    stats.bytes_paced = bytes_paced_;
+    stats.throttled_writes = throttled_writes_;
+    stats.throttle_wait_ms = throttle_wait_us_ / 1000;
+    return stats;
+}
+
+void BandwidthScheduler::pace(Stream& stream, size_t size) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto start = Clock::now();
+    auto now = start;
+    stream.last_active_ = now;
+
+    while (true) {
+        if (total_rate_ > 0) {
+            tokens_ = std::min(burst_, tokens_ + secondsBetween(last_refill_, now) * total_rate_);
+            last_refill_ = now;
+        }
+
+        double rate = streamRate(now);
+        if (rate > 0) {
+            stream.tokens_ = std::min(burst_, stream.tokens_ + secondsBetween(stream.last_refill_, now) * rate);
+        }
+        stream.last_refill_ = now;
+
+        // Buckets may go into debt, so a write larger than the burst still
+        // passes once both are positive; the debt delays the next write
+        bool global_ok = total_rate_ == 0 || tokens_ > 0;
+        bool stream_ok = rate <= 0 || stream.tokens_ > 0;
+        if (global_ok && stream_ok) {
+            if (total_rate_ > 0) {
+                tokens_ -= static_cast<double>(size);
+            }
+            if (rate > 0) {
+                stream.tokens_ -= static_cast<double>(size);
+            }
+            bytes_paced_ += size;
+            if (now != start) {
+                ++throttled_writes_;
+                throttle_wait_us_ += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(now - start).count());
+            }
+            return;
+        }
+
+        double wait = 0;
+        if (!global_ok) {
+            wait = std::max(wait, -tokens_ / static_cast<double>(total_rate_));
+        }
+        if (!stream_ok) {
+            wait = std::max(wait, -stream.tokens_ / rate);
+        }
+
+        // Wake up at least every MAX_WAIT: the share grows when other streams go idle
+        auto delay = std::min<Clock::duration>(
+            std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(wait)), MAX_WAIT);
+        refilled_.wait_for(lock, std::max<Clock::duration>(delay, std::chrono::milliseconds(1)));
+        now = Clock::now();
+        stream.last_active_ = now;
+    }
+}
+
+double BandwidthScheduler::streamRate(Clock::time_point now) {
+    if (now - last_count_ >= RECOUNT_INTERVAL) {
+        active_streams_ = static_cast<size_t>(std::count_if(streams_.begin(), streams_.end(),
+            [now](const Stream* stream) { return now - stream->last_active_ < ACTIVE_WINDOW; }));
+        last_count_ = now;
+    }
+
+    double rate = std::numeric_limits<double>::infinity();
+    if (total_rate_ > 0) {
+        rate = static_cast<double>(total_rate_) / static_cast<double>(std::max<size_t>(1, active_streams_));
+    }
+    if (stream_cap_ > 0) {
+        rate = std::min(rate, static_cast<double>(stream_cap_));
+    }
+    return rate == std::numeric_limits<double>::infinity() ? 0 : rate;
+}
+
+void BandwidthScheduler::close(Stream& stream) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        streams_.erase(stream.position_);
+    }
+    // Waiting streams pick up the departed stream's share on their next recount
+    refilled_.notify_all();
+}
+
+} // namespace utec
@@ -0,0 +1,77 @@
+// src/server/bandwidth_scheduler.h
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace utec {
+
+    // Paces video streams so one bulk download cannot starve the viewers in
+    // the browser. A global token bucket enforces the total rate; every stream
+    // also has its own bucket, refilled at an equal share of the total among
+    // the streams that are currently moving data, optionally capped further.
+    class BandwidthScheduler : public std::enable_shared_from_this<BandwidthScheduler> {
+    public:
+        struct Stats {
+            uint64_t open_streams = 0;
+            uint64_t active_streams = 0;
+            uint64_t fair_share_rate = 0;    // bytes/s per active stream, 0 when unlimited
+            uint64_t bytes_paced = 0;
+            uint64_t throttled_writes = 0;
+            uint64_t throttle_wait_ms = 0;
+        };
+
+        class Stream {
+        public:
+            ~Stream();
+
+            // Blocks until the stream may send size more bytes
+            void pace(size_t size);
+
+        private:
+            friend class BandwidthScheduler;
+            using Clock = std::chrono::steady_clock;
+
+            std::shared_ptr<BandwidthScheduler> scheduler_;
+            std::list<Stream*>::iterator position_;
+            double tokens_ = 0;
+            Clock::time_point last_refill_;
+            Clock::time_point last_active_;
+        };
+
+        // total_rate and stream_cap are in bytes/s, 0 meaning unlimited
+        BandwidthScheduler(uint64_t total_rate, uint64_t stream_cap, size_t burst);
+
+        bool enabled() const { return total_rate_ > 0 || stream_cap_ > 0; }
+        std::shared_ptr<Stream> open();
+        Stats stats() const;
+
+    private:
+        using Clock = Stream::Clock;
+
+        uint64_t total_rate_;
+        uint64_t stream_cap_;
+        double burst_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable refilled_;
+        std::list<Stream*> streams_;
+        double tokens_;
+        Clock::time_point last_refill_;
+        Clock::time_point last_count_;
+        size_t active_streams_ = 0;
+
+        uint64_t bytes_paced_ = 0;
+        uint64_t throttled_writes_ = 0;
+        uint64_t throttle_wait_us_ = 0;
+
+        void pace(Stream& stream, size_t size);
+        double streamRate(Clock::time_point now);
+        void close(Stream& stream);
+    };
+
+} // namespace utec
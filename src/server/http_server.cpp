@@ -1,11 +1,14 @@
 // src/server/http_server.cpp
 #include "server/http_server.h"
 #include "server/route_handler.h"
+#include "server/admission_controller.h"
 #include "filesystem/directory_scanner.h"
+#include "filesystem/scan_throttle.h"
 #include "api/video_api.h"
 #include "core/error_handler.h"
 #include "utils/logger.h"
 #include "httplib.h"
+#include <algorithm>
 #include <thread>
 #include <memory>
 
@@ -19,11 +22,26 @@ HttpServer::HttpServer(const ServerConfig& config)
     }
 
     // Initialize components
-    scanner_ = std::make_shared<DirectoryScanner>(config_.root_path);
-    api_ = std::make_shared<VideoApi>(scanner_);
-    routes_ = std::make_shared<RouteHandler>(api_, config_.root_path, config_);
+    scanner_ = std::make_shared<DirectoryScanner>(config_.root_path, config_.scan_threads,
+                                                  config_.lazy_library_scan);
+    scanner_->setThrottle(std::make_shared<ScanThrottle>(
+        config_.scan_ops_per_second, std::chrono::milliseconds(config_.scan_backoff_latency_ms),
+        config_.scan_idle_io_priority));
+    api_ = std::make_shared<VideoApi>(scanner_, config_.library_change_log_size, config_.precompress_responses);
+
+    // Streams never take the workers reserved for the API and the index page
+    size_t stream_workers = config_.worker_threads - config_.api_reserve_threads;
+    size_t max_streams = config_.max_concurrent_streams > 0
+        ? std::min(config_.max_concurrent_streams, stream_workers) : stream_workers;
+    admission_ = std::make_shared<AdmissionController>(max_streams, config_.api_reserve_threads,
+                                                       config_.retry_after);
+    routes_ = std::make_shared<RouteHandler>(api_, config_.root_path, config_, admission_);
 
     server_ = std::make_unique<httplib::Server>();
+    server_->new_task_queue = [this]() {
+        return admission_->createTaskQueue(config_.worker_threads, config_.max_queued_connections,
+                                           config_.shed_threads);
+    };
 }
 
 HttpServer::~HttpServer() {
@@ -44,6 +62,10 @@ bool HttpServer::start() {
 
     setupRoutes();
 
+    // The previous run's library is served right away and checked against
+    // the disk once the server is up
+    bool index_loaded = !config_.library_index_path.empty() && api_->loadIndex(config_.library_index_path);
+
     Logger::info("Starting HTTP server on " + config_.bind_address + ":" + std::to_string(config_.port));
 
     // Start server in a separate thread
@@ -59,11 +81,25 @@ bool HttpServer::start() {
         }
     });
 
-    // Give the server a moment to start
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // Returns once the socket is listening, or binding has failed
+    server_->wait_until_ready();
 
     if (server_->is_running()) {
         running_ = true;
+        if (config_.enable_library_watch) {
+            api_->startWatching(std::chrono::milliseconds(config_.library_watch_delay),
+                                std::chrono::milliseconds(config_.library_watch_max_delay));
+        }
+        if (config_.cache_refresh_interval > 0) {
+            api_->startPolling(std::chrono::seconds(config_.cache_refresh_interval));
+        }
+        if (index_loaded) {
+            api_->verifyIndex();
+        }
+        if (config_.lazy_library_scan) {
+            api_->startCrawling(config_.library_crawl_batch,
+                                std::chrono::milliseconds(config_.library_crawl_delay));
+        }
         printStartupInfo();
         return true;
     }
@@ -82,6 +118,8 @@ void HttpServer::stop() {
     Logger::info("Stopping HTTP server...");
     running_ = false;
 
+    api_->stopWatching();
+
     if (server_) {
         server_->stop();
     }
@@ -159,6 +197,21 @@ void HttpServer::setupRoutes() {
         }
     });
 
+    server.Get("/api/library/changes", [this](const httplib::Request& req, httplib::Response& res) {
+        try {
+            routes_->handleLibraryChanges(req, res);
+        } catch (const ServerException& e) {
+            ErrorHandler::logError(e);
+            res.status = e.getHttpStatus();
+            res.set_content(ErrorHandler::formatErrorResponse(e), "application/json");
+        } catch (const std::exception& e) {
+            ErrorHandler::logError("handleLibraryChanges", e);
+            res.status = 500;
+            res.set_content(ErrorHandler::formatErrorResponse(ErrorCode::INTERNAL_ERROR,
+                "Failed to load library changes"), "application/json");
+        }
+    });
+
     server.Get("/api/video", [this](const httplib::Request& req, httplib::Response& res) {
         try {
             routes_->handleVideo(req, res);
@@ -174,6 +227,32 @@ void HttpServer::setupRoutes() {
         }
     });
 
+    server.Get("/api/search", [this](const httplib::Request& req, httplib::Response& res) {
+        try {
+            routes_->handleSearch(req, res);
+        } catch (const ServerException& e) {
+            ErrorHandler::logError(e);
+            res.status = e.getHttpStatus();
+            res.set_content(ErrorHandler::formatErrorResponse(e), "application/json");
+        } catch (const std::exception& e) {
+            ErrorHandler::logError("handleSearch", e);
+            res.status = 500;
+            res.set_content(ErrorHandler::formatErrorResponse(ErrorCode::INTERNAL_ERROR,
+                "Failed to search videos"), "application/json");
+        }
+    });
+
+    server.Get("/api/metrics", [this](const httplib::Request& req, httplib::Response& res) {
+        try {
+            routes_->handleMetrics(req, res);
+        } catch (const std::exception& e) {
+            ErrorHandler::logError("handleMetrics", e);
+            res.status = 500;
+            res.set_content(ErrorHandler::formatErrorResponse(ErrorCode::INTERNAL_ERROR,
+                "Failed to collect metrics"), "application/json");
+        }
+    });
+
     // Video streaming with enhanced error handling
     server.Get("/stream/(.*)", [this](const httplib::Request& req, httplib::Response& res) {
         try {
@@ -197,15 +276,25 @@ void HttpServer::setupRoutes() {
         }
     });
 
-    // Enable CORS if configured
-    if (config_.enable_cors) {
-        server.set_pre_routing_handler([](const httplib::Request& req, httplib::Response& res) {
+    // CORS headers, then load shedding for connections the workers could not take
+    server.set_pre_routing_handler([this](const httplib::Request& req, httplib::Response& res) {
+        if (config_.enable_cors) {
             res.set_header("Access-Control-Allow-Origin", "*");
             res.set_header("Access-Control-Allow-Methods", "GET, POST, OPTIONS");
-            res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
-            return httplib::Server::HandlerResponse::Unhandled;
-        });
+            res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization, If-None-Match");
+        }
+        if (admission_->shedIfOverloaded(req, res)) {
+            return httplib::Server::HandlerResponse::Handled;
+        }
+        return httplib::Server::HandlerResponse::Unhandled;
+    });
 
+    // Keep-alive only while it does not cost the API its reserved workers
+    server.set_post_routing_handler([this](const httplib::Request& req, httplib::Response& res) {
+        admission_->limitKeepAlive(req, res);
+    });
+
+    if (config_.enable_cors) {
         // Handle OPTIONS requests for CORS
         server.Options(".*", [](const httplib::Request&, httplib::Response& res) {
             return;
@@ -213,9 +302,25 @@ void HttpServer::setupRoutes() {
     }
 
     // Global error handler
-    server.set_error_handler([](const httplib::Request& req, httplib::Response& res) {
+    server.set_error_handler([this](const httplib::Request& req, httplib::Response& res) {
+        try {
+            if (routes_->handleRejectedRange(req, res)) {
+                return;
+            }
+        } catch (const std::exception& e) {
+            ErrorHandler::logError("handleRejectedRange", e);
+            res.status = 500;
+            res.set_content("Internal server error", "text/plain");
+            return;
+        }
+
         Logger::error("HTTP error " + std::to_string(res.status) + " for " + req.path);
 
+        // Keep bodies the route handlers already chose (404 "Video not found", 416, ...)
+        if (!res.body.empty()) {
+            return;
+        }
+
         if (req.path.find("/api/") == 0) {
             // API endpoints should return JSON errors
             res.set_content(ErrorHandler::formatErrorResponse(ErrorCode::RESOURCE_NOT_FOUND,
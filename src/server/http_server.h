@@ -15,6 +15,7 @@ namespace utec {
     class DirectoryScanner;
     class VideoApi;
     class RouteHandler;
+    class AdmissionController;
 
     class HttpServer {
     public:
@@ -35,6 +36,7 @@ namespace utec {
         std::shared_ptr<DirectoryScanner> scanner_;
         std::shared_ptr<VideoApi> api_;
         std::shared_ptr<RouteHandler> routes_;
+        std::shared_ptr<AdmissionController> admission_;
 
         std::unique_ptr<httplib::Server> server_;
         std::thread server_thread_;
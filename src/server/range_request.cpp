@@ -0,0 +1,248 @@
+// src/server/range_request.cpp
+#include "server/range_request.h"
+#include <cstdio>
+#include <limits>
+
+namespace utec {
+
+namespace {
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t';
+    }
+
+    std::string_view trim(std::string_view s) {
+        while (!s.empty() && isSpace(s.front())) s.remove_prefix(1);
+        while (!s.empty() && isSpace(s.back())) s.remove_suffix(1);
+        return s;
+    }
+
+    // Parses a run of digits; values that do not fit saturate, which keeps
+    // huge first-byte positions unsatisfiable and huge last positions clamped
+    bool parseNumber(std::string_view s, uint64_t& value) {
+        if (s.empty()) {
+            return false;
+        }
+
+        value = 0;
+        for (char c : s) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            uint64_t digit = static_cast<uint64_t>(c - '0');
+            if (value > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+                value = std::numeric_limits<uint64_t>::max();
+            } else {
+                value = value * 10 + digit;
+            }
+        }
+        return true;
+    }
+
+    bool startsWithBytesUnit(std::string_view& s) {
+        static constexpr std::string_view unit = "bytes";
+        if (s.size() < unit.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < unit.size(); ++i) {
+            char c = s[i];
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+            if (c != unit[i]) {
+                return false;
+            }
+        }
+        s = trim(s.substr(unit.size()));
+        if (s.empty() || s.front() != '=') {
+            return false;
+        }
+        s.remove_prefix(1);
+        return true;
+    }
+
+} // namespace
+
+RangeRequest RangeRequest::ignored(uint64_t representation_size) {
+    RangeRequest request;
+    request.size_ = representation_size;
+    return request;
+}
+
+RangeRequest RangeRequest::parse(std::string_view header, uint64_t representation_size) {
+    RangeRequest request;
+    request.size_ = representation_size;
+
+    std::string_view spec_list = trim(header);
+    if (spec_list.empty() || !startsWithBytesUnit(spec_list)) {
+        return request;
+    }
+
+    size_t syntactically_valid = 0;
+    while (!spec_list.empty()) {
+        size_t comma = spec_list.find(',');
+        std::string_view spec = trim(spec_list.substr(0, comma));
+        spec_list = comma == std::string_view::npos ? std::string_view() : spec_list.substr(comma + 1);
+
+        // The #rule allows empty list elements
+        if (spec.empty()) {
+            continue;
+        }
+
+        size_t dash = spec.find('-');
+        if (dash == std::string_view::npos) {
+            return ignored(representation_size);
+        }
+
+        std::string_view first_text = trim(spec.substr(0, dash));
+        std::string_view last_text = trim(spec.substr(dash + 1));
+        ByteRange range{0, 0};
+        bool satisfiable = false;
+
+        if (first_text.empty()) {
+            // suffix-byte-range-spec: the final N bytes
+            uint64_t suffix_length;
+            if (!parseNumber(last_text, suffix_length)) {
+                return ignored(representation_size);
+            }
+            if (suffix_length > 0 && representation_size > 0) {
+                range.first = suffix_length >= representation_size ? 0 : representation_size - suffix_length;
+                range.last = representation_size - 1;
+                satisfiable = true;
+            }
+        } else {
+            uint64_t first;
+            if (!parseNumber(first_text, first)) {
+                return ignored(representation_size);
+            }
+
+            uint64_t last = std::numeric_limits<uint64_t>::max();
+            if (!last_text.empty()) {
+                if (!parseNumber(last_text, last) || last < first) {
+                    return ignored(representation_size);
+                }
+            }
+
+            if (first < representation_size) {
+                range.first = first;
+                range.last = last < representation_size ? last : representation_size - 1;
+                satisfiable = true;
+            }
+        }
+
+        ++syntactically_valid;
+        if (!satisfiable) {
+            continue;
+        }
+
+        // Too many ranges is a denial-of-service pattern; RFC 7233 lets us ignore them
+        if (request.count_ == MAX_RANGES) {
+            return ignored(representation_size);
+        }
+        request.ranges_[request.count_++] = range;
+    }
+
+    if (syntactically_valid == 0) {
+        return request;
+    }
+
+    if (request.count_ == 0) {
+        request.status_ = Status::UNSATISFIABLE;
+        return request;
+    }
+
+    request.coalesce();
+    request.status_ = Status::SATISFIABLE;
+    return request;
+}
+
+bool RangeRequest::ifRangeMatches(std::string_view if_range, std::string_view etag,
+                                  std::string_view last_modified) {
+    if_range = trim(if_range);
+    if (if_range.empty() || if_range.substr(0, 2) == "W/") {
+        return false;
+    }
+    if (if_range.front() == '"') {
+        return !etag.empty() && if_range == etag;
+    }
+    return !last_modified.empty() && if_range == last_modified;
+}
+
+void RangeRequest::coalesce() {
+    // Insertion sort: at most MAX_RANGES entries
+    for (size_t i = 1; i < count_; ++i) {
+        ByteRange current = ranges_[i];
+        size_t j = i;
+        while (j > 0 && ranges_[j - 1].first > current.first) {
+            ranges_[j] = ranges_[j - 1];
+            --j;
+        }
+        ranges_[j] = current;
+    }
+
+    size_t merged = 0;
+    for (size_t i = 1; i < count_; ++i) {
+        ByteRange& tail = ranges_[merged];
+        if (ranges_[i].first <= tail.last + 1) {
+            if (ranges_[i].last > tail.last) {
+                tail.last = ranges_[i].last;
+            }
+        } else {
+            ranges_[++merged] = ranges_[i];
+        }
+    }
+    count_ = merged + 1;
+}
+
+MultipartByteRanges::MultipartByteRanges(const RangeRequest& ranges, std::string_view content_type,
+                                         std::string_view boundary)
+    : ranges_(ranges), content_type_(content_type), boundary_(boundary) {
+    char scratch[MAX_PART_HEADER];
+    for (size_t i = 0; i < ranges_.count(); ++i) {
+        content_length_ += renderPartHeader(i, scratch) + ranges_[i].length();
+    }
+    content_length_ += renderTrailer(scratch);
+}
+
+MultipartByteRanges::Segment MultipartByteRanges::locate(uint64_t body_offset, char* scratch) const {
+    for (size_t i = 0; i < ranges_.count(); ++i) {
+        size_t header_length = renderPartHeader(i, scratch);
+        if (body_offset < header_length) {
+            return Segment{scratch + body_offset, 0, header_length - body_offset};
+        }
+        body_offset -= header_length;
+
+        const ByteRange& range = ranges_[i];
+        if (body_offset < range.length()) {
+            return Segment{nullptr, range.first + body_offset, range.length() - body_offset};
+        }
+        body_offset -= range.length();
+    }
+
+    size_t trailer_length = renderTrailer(scratch);
+    if (body_offset < trailer_length) {
+        return Segment{scratch + body_offset, 0, trailer_length - body_offset};
+    }
+    return Segment{nullptr, 0, 0};
+}
+
+size_t MultipartByteRanges::renderPartHeader(size_t index, char* out) const {
+    const ByteRange& range = ranges_[index];
+    int written = std::snprintf(out, MAX_PART_HEADER,
+        "%s--%.*s\r\nContent-Type: %.*s\r\nContent-Range: bytes %llu-%llu/%llu\r\n\r\n",
+        index == 0 ? "" : "\r\n",
+        static_cast<int>(boundary_.size()), boundary_.data(),
+        static_cast<int>(content_type_.size()), content_type_.data(),
+        static_cast<unsigned long long>(range.first),
+        static_cast<unsigned long long>(range.last),
+        static_cast<unsigned long long>(ranges_.representationSize()));
+    return written < 0 ? 0 : static_cast<size_t>(written) < MAX_PART_HEADER ? static_cast<size_t>(written)
+                                                                           : MAX_PART_HEADER - 1;
+}
+
+size_t MultipartByteRanges::renderTrailer(char* out) const {
+    int written = std::snprintf(out, MAX_PART_HEADER, "\r\n--%.*s--\r\n",
+                                static_cast<int>(boundary_.size()), boundary_.data());
+    return written < 0 ? 0 : static_cast<size_t>(written) < MAX_PART_HEADER ? static_cast<size_t>(written)
+                                                                           : MAX_PART_HEADER - 1;
+}
+
+} // namespace utec
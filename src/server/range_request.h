@@ -0,0 +1,81 @@
+// src/server/range_request.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace utec {
+
+    struct ByteRange {
+        uint64_t first;
+        uint64_t last;   // inclusive
+
+        uint64_t length() const { return last - first + 1; }
+    };
+
+    // RFC 7233 byte-range evaluation against a representation of known size.
+    // Parsing works on the header text in place and keeps the resolved ranges
+    // in a fixed array, so evaluating a request never allocates.
+    class RangeRequest {
+    public:
+        static constexpr size_t MAX_RANGES = 16;
+
+        enum class Status {
+            IGNORED,        // no usable Range header: send the full representation
+            SATISFIABLE,    // 206 with one or more ranges
+            UNSATISFIABLE   // 416
+        };
+
+        static RangeRequest parse(std::string_view header, uint64_t representation_size);
+
+        // If-Range: a strong entity tag must equal etag, an HTTP-date must equal
+        // last_modified exactly. Weak tags never match.
+        static bool ifRangeMatches(std::string_view if_range, std::string_view etag,
+                                   std::string_view last_modified);
+
+        Status status() const { return status_; }
+        size_t count() const { return count_; }
+        const ByteRange& operator[](size_t index) const { return ranges_[index]; }
+        uint64_t representationSize() const { return size_; }
+
+    private:
+        Status status_ = Status::IGNORED;
+        uint64_t size_ = 0;
+        size_t count_ = 0;
+        ByteRange ranges_[MAX_RANGES];
+
+        static RangeRequest ignored(uint64_t representation_size);
+        void coalesce();
+    };
+
+    // Layout of a multipart/byteranges body. Part headers are rendered on
+    // demand, so the body can be streamed in any slices without building it.
+    class MultipartByteRanges {
+    public:
+        static constexpr size_t MAX_PART_HEADER = 256;
+
+        MultipartByteRanges(const RangeRequest& ranges, std::string_view content_type,
+                            std::string_view boundary);
+
+        uint64_t contentLength() const { return content_length_; }
+
+        struct Segment {
+            const char* text;       // header or trailer bytes, nullptr for file data
+            uint64_t file_offset;   // valid when text == nullptr
+            uint64_t length;        // bytes left in this segment from the requested offset
+        };
+
+        // Resolves a body offset; text points into scratch, which must hold MAX_PART_HEADER bytes
+        Segment locate(uint64_t body_offset, char* scratch) const;
+
+    private:
+        const RangeRequest& ranges_;
+        std::string_view content_type_;
+        std::string_view boundary_;
+        uint64_t content_length_ = 0;
+
+        size_t renderPartHeader(size_t index, char* out) const;
+        size_t renderTrailer(char* out) const;
+    };
+
+} // namespace utec
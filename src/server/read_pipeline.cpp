@@ -0,0 +1,127 @@
+// src/server/read_pipeline.cpp
+#include "server/read_pipeline.h"
+#include "filesystem/async_read_engine.h"
+#include "filesystem/file_handle_cache.h"
+#include "utils/logger.h"
+#include <algorithm>
+
+namespace utec {
+
+ReadPipeline::ReadPipeline(std::shared_ptr<AsyncReadEngine> engine, std::shared_ptr<StreamBufferPool> pool,
+                           std::shared_ptr<FileHandle> file, size_t depth, std::chrono::milliseconds timeout)
+    : engine_(std::move(engine)), pool_(std::move(pool)), file_(std::move(file)),
+      depth_(std::max<size_t>(1, depth)), timeout_(timeout) {
+}
+
+ReadPipeline::~ReadPipeline() {
+    // The engine writes into our buffers until each callback has run
+    std::unique_lock<std::mutex> lock(mutex_);
+    completed_.wait(lock, [this] { return !anyPending(); });
+}
+
+bool ReadPipeline::write(uint64_t offset, size_t length, const Writer& write) {
+    if (slots_.empty() && !allocate()) {
+        Logger::warning("Timed out waiting for stream buffer budget");
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    end_ = offset + length;
+
+    Slot* head = &slots_[head_];
+    if (head->state == SlotState::IDLE || head->offset + head->consumed != offset) {
+        restart(offset, lock);
+        head = &slots_[head_];
+    }
+
+    completed_.wait(lock, [head] { return head->state != SlotState::PENDING; });
+    if (head->result <= 0 || head->consumed >= static_cast<size_t>(head->result)) {
+        return false;
+    }
+
+    const char* data = head->buffer.data() + head->consumed;
+    size_t size = std::min(static_cast<size_t>(head->result) - head->consumed, length);
+
+    // The socket write overlaps with the reads queued behind this slot
+    lock.unlock();
+    bool written = write(data, size);
+    lock.lock();
+    if (!written) {
+        return false;
+    }
+
+    head->consumed += size;
+    if (head->consumed == static_cast<size_t>(head->result)) {
+        head->state = SlotState::IDLE;
+        head_ = (head_ + 1) % slots_.size();
+        schedule();
+    }
+    return true;
+}
+
+bool ReadPipeline::allocate() {
+    // The first buffer waits for budget like any buffered stream; the extra
+    // depth is only taken when the pool has it to spare
+    auto first = pool_->acquire(timeout_);
+    if (!first) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_.reserve(depth_);
+    slots_.emplace_back();
+    slots_.back().buffer = std::move(first);
+
+    while (slots_.size() < depth_) {
+        auto extra = pool_->acquire(std::chrono::milliseconds(0));
+        if (!extra) {
+            break;
+        }
+        slots_.emplace_back();
+        slots_.back().buffer = std::move(extra);
+    }
+    return true;
+}
+
+void ReadPipeline::restart(uint64_t offset, std::unique_lock<std::mutex>& lock) {
+    completed_.wait(lock, [this] { return !anyPending(); });
+    for (auto& slot : slots_) {
+        slot.state = SlotState::IDLE;
+    }
+    head_ = 0;
+    next_offset_ = offset;
+    schedule();
+}
+
+void ReadPipeline::schedule() {
+    // Idle slots always trail the busy ones in ring order, so walking from the
+    // head keeps the reads in file order
+    for (size_t i = 0; i < slots_.size() && next_offset_ < end_; ++i) {
+        size_t index = (head_ + i) % slots_.size();
+        Slot& slot = slots_[index];
+        if (slot.state != SlotState::IDLE) {
+            continue;
+        }
+
+        size_t length = static_cast<size_t>(std::min<uint64_t>(slot.buffer.size(), end_ - next_offset_));
+        slot.state = SlotState::PENDING;
+        slot.offset = next_offset_;
+        slot.result = 0;
+        slot.consumed = 0;
+        next_offset_ += length;
+
+        engine_->submit(file_, slot.buffer.data(), length, slot.offset, [this, index](long long result) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            slots_[index].result = result;
+            slots_[index].state = SlotState::READY;
+            completed_.notify_all();
+        });
+    }
+}
+
+bool ReadPipeline::anyPending() const {
+    return std::any_of(slots_.begin(), slots_.end(),
+                       [](const Slot& slot) { return slot.state == SlotState::PENDING; });
+}
+
+} // namespace utec
@@ -0,0 +1,62 @@
+// src/server/read_pipeline.h
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "server/stream_buffer_pool.h"
+
+namespace utec {
+
+    class AsyncReadEngine;
+    class FileHandle;
+
+    // Keeps several sequential reads of one stream in flight, so the disk works
+    // ahead of the socket instead of after it. Each read lands in a buffer from
+    // the shared stream pool; under memory pressure the pipeline runs shallower.
+    class ReadPipeline {
+    public:
+        using Writer = std::function<bool(const char* data, size_t size)>;
+
+        ReadPipeline(std::shared_ptr<AsyncReadEngine> engine, std::shared_ptr<StreamBufferPool> pool,
+                     std::shared_ptr<FileHandle> file, size_t depth, std::chrono::milliseconds timeout);
+        ~ReadPipeline();   // waits for reads still in flight
+
+        // Hands the bytes at offset to write. Reads never go past offset + length.
+        bool write(uint64_t offset, size_t length, const Writer& write);
+
+    private:
+        enum class SlotState { IDLE, PENDING, READY };
+
+        struct Slot {
+            StreamBufferPool::Buffer buffer;
+            SlotState state = SlotState::IDLE;
+            uint64_t offset = 0;
+            long long result = 0;
+            size_t consumed = 0;
+        };
+
+        std::shared_ptr<AsyncReadEngine> engine_;
+        std::shared_ptr<StreamBufferPool> pool_;
+        std::shared_ptr<FileHandle> file_;
+        size_t depth_;
+        std::chrono::milliseconds timeout_;
+
+        std::mutex mutex_;
+        std::condition_variable completed_;
+        std::vector<Slot> slots_;
+        size_t head_ = 0;
+        uint64_t next_offset_ = 0;
+        uint64_t end_ = 0;
+
+        bool allocate();
+        void restart(uint64_t offset, std::unique_lock<std::mutex>& lock);
+        void schedule();
+        bool anyPending() const;
+    };
+
+} // namespace utec
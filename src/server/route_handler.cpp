@@ -1,30 +1,202 @@
 // src/server/route_handler.cpp
 #include "server/route_handler.h"
 #include "api/video_api.h"
+#include "api/json_response.h"
+#include "config/server_config.h"
 #include "web/embedded_resources.h"
 #include "filesystem/file_utils.h"
+#include "filesystem/async_read_engine.h"
+#include "filesystem/block_cache.h"
+#include "filesystem/directory_scanner.h"
+#include "filesystem/file_handle_cache.h"
+#include "filesystem/library_poller.h"
+#include "filesystem/library_watcher.h"
+#include "filesystem/mapped_file.h"
+#include "filesystem/read_ahead.h"
+#include "filesystem/scan_throttle.h"
+#include "server/admission_controller.h"
+#include "server/bandwidth_scheduler.h"
+#include "server/range_request.h"
+#include "server/read_pipeline.h"
+#include "server/stream_buffer_pool.h"
 #include "utils/string_utils.h"
 #include "utils/logger.h"
 #include "httplib.h"
-#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <map>
+#include <string_view>
 
 namespace utec {
 
-RouteHandler::RouteHandler(std::shared_ptr<VideoApi> api, const std::string& root_path)
-    : api_(api), root_path_(root_path) {
+namespace {
+
+    // Index pages kept per Host header; further hosts get the page uncompressed
+    constexpr size_t MAX_INDEX_BODIES = 16;
+
+    // /api/search: results per response, and the longest query accepted
+    constexpr size_t DEFAULT_SEARCH_LIMIT = 50;
+    constexpr size_t MAX_SEARCH_LIMIT = 500;
+    constexpr size_t MAX_SEARCH_QUERY = 256;
+
+    // Owns the strings the multipart layout points into; never moved once built
+    struct MultipartBody {
+        MultipartBody(const RangeRequest& ranges, std::string content_type, std::string boundary)
+            : ranges(ranges), content_type(std::move(content_type)), boundary(std::move(boundary)),
+              layout(this->ranges, this->content_type, this->boundary) {
+        }
+
+        RangeRequest ranges;
+        std::string content_type;
+        std::string boundary;
+        MultipartByteRanges layout;
+    };
+
+    // httplib parses Range into req.ranges before routing and slices any 2xx
+    // body again while the list is not empty. A content provider without a
+    // length does not avoid it: httplib then checks the ranges against a
+    // zero length and answers 416. /stream applies RangeRequest itself, so
+    // the parsed list is dropped here, the one place the request is modified
+    void dropParsedRanges(const httplib::Request& req) {
+        const_cast<httplib::Request&>(req).ranges.clear();
+    }
+
+    std::string makeBoundary() {
+        static std::atomic<uint64_t> counter{0};
+        auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        char boundary[48];
+        std::snprintf(boundary, sizeof(boundary), "utec-%016llx-%08llx",
+                      static_cast<unsigned long long>(now),
+                      static_cast<unsigned long long>(counter.fetch_add(1)));
+        return boundary;
+    }
+
+    // Reads one byte per page, so the page faults of a mapped chunk happen
+    // here, where they can be timed, instead of inside the socket write
+    void prefault(const char* data, size_t size) {
+        constexpr size_t PAGE = 4096;
+        volatile char touched = 0;
+        for (size_t offset = 0; offset < size; offset += PAGE) {
+            touched = data[offset];
+        }
+        if (size > 0) {
+            touched = data[size - 1];
+        }
+        (void)touched;
+    }
+
+    // Strong validator: changes whenever the cache would reopen the file
+    std::string makeETag(const FileHandle& file) {
+        char etag[64];
+        std::snprintf(etag, sizeof(etag), "\"%llx-%llx-%llx\"",
+                      static_cast<unsigned long long>(file.inode()),
+                      static_cast<unsigned long long>(file.size()),
+                      static_cast<unsigned long long>(file.mtime()));
+        return etag;
+    }
+
+    // If-None-Match uses the weak comparison: W/ prefixes are ignored
+    bool entityTagListMatches(std::string_view header, std::string_view etag) {
+        size_t pos = 0;
+        while (pos < header.size()) {
+            size_t comma = header.find(',', pos);
+            std::string_view tag = header.substr(pos, comma == std::string_view::npos ? std::string_view::npos
+                                                                                      : comma - pos);
+            pos = comma == std::string_view::npos ? header.size() : comma + 1;
+
+            while (!tag.empty() && (tag.front() == ' ' || tag.front() == '\t')) tag.remove_prefix(1);
+            while (!tag.empty() && (tag.back() == ' ' || tag.back() == '\t')) tag.remove_suffix(1);
+            if (tag == "*") {
+                return true;
+            }
+            if (tag.substr(0, 2) == "W/") {
+                tag.remove_prefix(2);
+            }
+            if (tag == etag) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Each encoding of a body is a separate representation and gets its own
+    // strong tag: the encoding's name goes before the closing quote
+    std::string encodedETag(const std::string& etag, ContentEncoding encoding) {
+        if (encoding == ContentEncoding::IDENTITY || etag.empty() || etag.back() != '"') {
+            return etag;
+        }
+        return etag.substr(0, etag.size() - 1) + "-" + EncodedBody::name(encoding) + "\"";
+    }
+
+    // Course and video bodies are tagged by their content: a course listed
+    // again can change them without a new library generation
+    std::string contentETag(uint64_t checksum) {
+        char etag[24];
+        std::snprintf(etag, sizeof(etag), "\"c-%016llx\"", static_cast<unsigned long long>(checksum));
+        return etag;
+    }
+
+    // Digits only; ::isdigit would take the negative chars of bytes past 0x7F
+    bool isDecimal(const std::string& value) {
+        return std::all_of(value.begin(), value.end(), [](char c) { return c >= '0' && c <= '9'; });
+    }
+
+} // namespace
+
+RouteHandler::RouteHandler(std::shared_ptr<VideoApi> api, const std::string& root_path,
+                           const ServerConfig& config, std::shared_ptr<AdmissionController> admission)
+    : api_(api), root_path_(root_path), config_(config),
+      buffer_pool_(std::make_shared<StreamBufferPool>(config.stream_buffer_size,
+                                                      config.stream_memory_budget)),
+      file_cache_(std::make_shared<FileHandleCache>(
+          config.file_cache_entries, std::chrono::seconds(config.file_cache_revalidate_interval))),
+      block_cache_(std::make_shared<BlockCache>(config.block_cache_size, config.block_cache_block_size,
+                                                config.block_cache_shards)),
+      read_ahead_(std::make_shared<ReadAheadTracker>(
+          config.read_ahead_min_window, config.read_ahead_max_window, config.read_ahead_sessions,
+          std::chrono::seconds(config.read_ahead_session_timeout))),
+      bandwidth_(std::make_shared<BandwidthScheduler>(
+          config.bandwidth_limit, config.stream_bandwidth_cap, config.bandwidth_burst)),
+      admission_(std::move(admission)), scan_throttle_(api_->getScanner()->getThrottle()) {
+    if (config.stream_read_mode == StreamReadMode::ASYNC) {
+        async_engine_ = AsyncReadEngine::create(config.async_io_prefer_io_uring, config.async_io_threads,
+                                                config.async_io_queue_depth);
+    }
+
+    css_body_ = std::make_shared<const EncodedBody>(EmbeddedResources::getMainCss(), config.precompress_responses);
+    js_body_ = std::make_shared<const EncodedBody>(EmbeddedResources::getMainJs(), config.precompress_responses);
 }
 
 void RouteHandler::handleIndex(const httplib::Request& req, httplib::Response& res) {
     Logger::debug("Serving index page");
 
     std::string server_url = getServerUrl(req);
-    std::string html = EmbeddedResources::processTemplate(
-        EmbeddedResources::getIndexHtml(),
-        server_url
-    );
+    std::shared_ptr<const EncodedBody> body;
+    {
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        auto it = index_bodies_.find(server_url);
+        if (it != index_bodies_.end()) {
+            body = it->second;
+        }
+    }
+
+    if (!body) {
+        std::string html = EmbeddedResources::processTemplate(
+            EmbeddedResources::getIndexHtml(),
+            server_url
+        );
+
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        bool keep = index_bodies_.size() < MAX_INDEX_BODIES;
+        body = std::make_shared<const EncodedBody>(std::move(html), keep && config_.precompress_responses);
+        if (keep) {
+            index_bodies_.emplace(server_url, body);
+        }
+    }
 
-    res.set_content(html, "text/html; charset=utf-8");
+    setEncodedContent(req, res, body, "text/html; charset=utf-8");
 }
 
 void RouteHandler::handleLibrary(const httplib::Request& req, httplib::Response& res) {
@@ -33,8 +205,10 @@ void RouteHandler::handleLibrary(const httplib::Request& req, httplib::Response&
     setCorsHeaders(res);
 
     try {
-        std::string json_response = api_->getLibrary();
-        res.set_content(json_response, "application/json; charset=utf-8");
+        if (isNotModified(req, res)) {
+            return;
+        }
+        setEncodedContent(req, res, api_->getLibrary(), "application/json; charset=utf-8");
     } catch (const std::exception& e) {
         Logger::error("Error getting library: " + std::string(e.what()));
         res.status = 500;
@@ -42,6 +216,33 @@ void RouteHandler::handleLibrary(const httplib::Request& req, httplib::Response&
     }
 }
 
+void RouteHandler::handleLibraryChanges(const httplib::Request& req, httplib::Response& res) {
+    setCorsHeaders(res);
+
+    // A generation from an earlier response, as a plain decimal number
+    auto since_param = req.get_param_value("since");
+    if (since_param.empty() || since_param.size() > 19 || !isDecimal(since_param)) {
+        res.status = 400;
+        res.set_content("{\"error\":\"Missing or invalid since parameter\"}", "application/json");
+        return;
+    }
+    uint64_t since = std::stoull(since_param);
+
+    Logger::debug("API: Getting library changes since generation " + since_param);
+
+    try {
+        if (isNotModified(req, res)) {
+            return;
+        }
+        std::string json_response = api_->getChanges(since);
+        res.set_content(json_response, "application/json; charset=utf-8");
+    } catch (const std::exception& e) {
+        Logger::error("Error getting library changes: " + std::string(e.what()));
+        res.status = 500;
+        res.set_content("{\"error\":\"Internal server error\"}", "application/json");
+    }
+}
+
 void RouteHandler::handleVideo(const httplib::Request& req, httplib::Response& res) {
     setCorsHeaders(res);
 
@@ -61,15 +262,24 @@ void RouteHandler::handleVideo(const httplib::Request& req, httplib::Response& r
     Logger::debug("API: Getting video/course info for " + course);
 
     try {
-        std::string json_response;
+        // Dated before the body is taken, so a change in between can only
+        // make the date too old
+        long long modified = api_->getContentModified();
         if (video.empty()) {
             // Return course information
-            json_response = api_->getCourse(year, semester, course);
+            auto body = api_->getCourse(year, semester, course);
+            if (isNotModified(req, res, contentETag(body->checksum()), modified)) {
+                return;
+            }
+            setEncodedContent(req, res, body, "application/json; charset=utf-8");
         } else {
             // Return specific video information
-            json_response = api_->getVideo(year, semester, course, video);
+            std::string json_response = api_->getVideo(year, semester, course, video);
+            if (isNotModified(req, res, contentETag(StringUtils::fnv1a(json_response)), modified)) {
+                return;
+            }
+            res.set_content(json_response, "application/json; charset=utf-8");
         }
-        res.set_content(json_response, "application/json; charset=utf-8");
     } catch (const std::exception& e) {
         Logger::error("Error getting video/course: " + std::string(e.what()));
         res.status = 404;
@@ -77,8 +287,72 @@ void RouteHandler::handleVideo(const httplib::Request& req, httplib::Response& r
     }
 }
 
+void RouteHandler::handleSearch(const httplib::Request& req, httplib::Response& res) {
+    setCorsHeaders(res);
+
+    auto query = req.get_param_value("q");
+    if (query.empty() || query.size() > MAX_SEARCH_QUERY) {
+        res.status = 400;
+        res.set_content("{\"error\":\"Missing or invalid q parameter\"}", "application/json");
+        return;
+    }
+
+    size_t limit = DEFAULT_SEARCH_LIMIT;
+    auto limit_param = req.get_param_value("limit");
+    if (!limit_param.empty()) {
+        if (limit_param.size() > 9 || !isDecimal(limit_param)) {
+            res.status = 400;
+            res.set_content("{\"error\":\"Invalid limit parameter\"}", "application/json");
+            return;
+        }
+        limit = std::min(std::max<size_t>(std::stoul(limit_param), 1), MAX_SEARCH_LIMIT);
+    }
+
+    Logger::debug("API: Searching videos for " + query);
+
+    try {
+        if (isNotModified(req, res)) {
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::string json_response = api_->searchVideos(query, limit);
+        searches_.fetch_add(1, std::memory_order_relaxed);
+        search_time_us_.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count()), std::memory_order_relaxed);
+        res.set_content(json_response, "application/json; charset=utf-8");
+    } catch (const std::exception& e) {
+        Logger::error("Error searching videos: " + std::string(e.what()));
+        res.status = 500;
+        res.set_content("{\"error\":\"Internal server error\"}", "application/json");
+    }
+}
+
 void RouteHandler::handleVideoStream(const httplib::Request& req, httplib::Response& res) {
-    std::string relative_path = req.matches[1];
+    streamVideo(req, res, req.matches[1]);
+}
+
+bool RouteHandler::handleRejectedRange(const httplib::Request& req, httplib::Response& res) {
+    static constexpr std::string_view prefix = "/stream/";
+    // Every 416 this handler sends carries Content-Range; one without it is
+    // httplib's answer to a header its parser could not read
+    if (res.status != 416 || res.has_header("Content-Range") ||
+        req.path.compare(0, prefix.size(), prefix.data(), prefix.size()) != 0) {
+        return false;
+    }
+
+    // httplib answered before routing, so the pre-routing handler never
+    // shed this request; a shedding thread must not start a stream
+    if (admission_->shedIfOverloaded(req, res)) {
+        return true;
+    }
+
+    Logger::debug("Ignoring unparsable Range header: " + req.get_header_value("Range"));
+    res.status = 200;
+    streamVideo(req, res, req.path.substr(prefix.size()));
+    return true;
+}
+
+void RouteHandler::streamVideo(const httplib::Request& req, httplib::Response& res, std::string relative_path) {
     relative_path = StringUtils::urlDecode(relative_path);
 
     std::string full_path = root_path_ + "/" + relative_path;
@@ -95,84 +369,418 @@ void RouteHandler::handleVideoStream(const httplib::Request& req, httplib::Respo
         return;
     }
 
-    if (!FileUtils::exists(full_path) || !FileUtils::isVideoFile(full_path)) {
+    // A cache hit answers without touching the filesystem; the handle carries
+    // the descriptor and the fstat() results it was opened with
+    auto file = FileUtils::isVideoFile(full_path) ? file_cache_->acquire(full_path) : nullptr;
+    if (!file) {
         Logger::warning("Video file not found: " + full_path);
         res.status = 404;
         res.set_content("Video not found", "text/plain");
         return;
     }
 
-    // Set video headers
-    setVideoHeaders(res, StringUtils::getBaseName(full_path));
+    std::string mime_type = getMimeType(StringUtils::getFileExtension(full_path));
+    setVideoHeaders(res, StringUtils::getBaseName(full_path), makeETag(*file),
+                    StringUtils::formatHttpDate(file->mtime() / 1000000000LL));
 
-    // Stream the file
-    std::ifstream file(full_path, std::ios::binary);
-    if (!file) {
-        Logger::error("Failed to open video file: " + full_path);
-        res.status = 500;
-        res.set_content("Internal server error", "text/plain");
+    dropParsedRanges(req);
+
+    if (file->size() == 0) {
+        res.set_content("", mime_type);
         return;
     }
 
-    // Get file size
-    size_t file_size = FileUtils::getFileSize(full_path);
+    RangeRequest ranges;
+    auto range_header = req.headers.find("Range");
+    if (config_.enable_range_requests && range_header != req.headers.end()) {
+        // A stale If-Range validator means the client gets the whole new file
+        auto if_range = req.headers.find("If-Range");
+        if (if_range == req.headers.end() ||
+            RangeRequest::ifRangeMatches(if_range->second, res.get_header_value("ETag"),
+                                         res.get_header_value("Last-Modified"))) {
+            ranges = RangeRequest::parse(range_header->second, file->size());
+        }
+    }
 
-    // Handle range requests for video seeking
-    auto range_header = req.get_header_value("Range");
-    if (!range_header.empty() && range_header.find("bytes=") == 0) {
-        // Parse range header (simplified implementation)
-        std::string range_spec = range_header.substr(6); // Remove "bytes="
-        auto dash_pos = range_spec.find('-');
+    // A stream keeps its worker until the last byte is written; past the
+    // limit the client is told to come back instead of waiting in line
+    std::shared_ptr<AdmissionController::StreamSlot> slot;
+    if (ranges.status() != RangeRequest::Status::UNSATISFIABLE) {
+        slot = admission_->admitStream();
+        if (!slot) {
+            admission_->reject(res);
+            return;
+        }
+    }
 
-        if (dash_pos != std::string::npos) {
-            size_t start = 0, end = file_size - 1;
+    FileWriter writer = makeFileWriter(file);
+    if (config_.enable_read_ahead && ranges.status() != RangeRequest::Status::UNSATISFIABLE) {
+        // Successive range requests from one player form a single session, so
+        // the prefetch window survives across them and resets on a seek
+        uint64_t start = ranges.status() == RangeRequest::Status::SATISFIABLE ? ranges[0].first : 0;
+        auto session = read_ahead_->begin(req.remote_addr, file, start);
+        size_t chunk_size = config_.stream_buffer_size;
+        writer = [session, chunk_size, inner = std::move(writer)](size_t offset, size_t length,
+                                                                 httplib::DataSink& sink) {
+            // length is everything left in the range; one call writes at most a chunk
+            session->onRead(offset, std::min(length, chunk_size));
+            return inner(offset, length, sink);
+        };
+    }
 
-            std::string start_str = range_spec.substr(0, dash_pos);
-            std::string end_str = range_spec.substr(dash_pos + 1);
+    writer = [slot, inner = std::move(writer)](size_t offset, size_t length, httplib::DataSink& sink) {
+        return inner(offset, length, sink);
+    };
 
-            if (!start_str.empty()) start = std::stoull(start_str);
-            if (!end_str.empty()) end = std::stoull(end_str);
+    if (bandwidth_->enabled()) {
+        auto stream = bandwidth_->open();
+        writer = [stream, inner = std::move(writer)](size_t offset, size_t length, httplib::DataSink& sink) {
+            // Writers choose their own chunk sizes, so pacing happens on the bytes
+            // actually handed to the socket
+            httplib::DataSink paced;
+            paced.write = [&stream, &sink](const char* data, size_t size) {
+                stream->pace(size);
+                return sink.write(data, size);
+            };
+            paced.is_writable = [&sink]() { return sink.is_writable(); };
+            return inner(offset, length, paced);
+        };
+    }
 
-            if (start <= end && end < file_size) {
-                size_t content_length = end - start + 1;
+    switch (ranges.status()) {
+        case RangeRequest::Status::UNSATISFIABLE:
+            res.status = 416;
+            res.set_header("Content-Range", "bytes */" + std::to_string(file->size()));
+            res.set_content("Range Not Satisfiable", "text/plain");
+            return;
 
-                res.status = 206; // Partial Content
-                res.set_header("Content-Range",
-                    "bytes " + std::to_string(start) + "-" + std::to_string(end) +
-                    "/" + std::to_string(file_size));
-                res.set_header("Content-Length", std::to_string(content_length));
+        case RangeRequest::Status::IGNORED:
+            res.status = 200;
+            res.set_content_provider(file->size(), mime_type, writer);
+            return;
 
-                file.seekg(start);
+        case RangeRequest::Status::SATISFIABLE:
+            break;
+    }
 
-                std::vector<char> buffer(std::min(content_length, size_t(64 * 1024))); // 64KB chunks
-                std::string content;
-                content.reserve(content_length);
+    res.status = 206;
+    if (ranges.count() == 1) {
+        ByteRange range = ranges[0];
+        res.set_header("Content-Range",
+            "bytes " + std::to_string(range.first) + "-" + std::to_string(range.last) +
+            "/" + std::to_string(file->size()));
+        res.set_content_provider(
+            range.length(), mime_type,
+            [writer, range](size_t offset, size_t length, httplib::DataSink& sink) {
+                return writer(range.first + offset, length, sink);
+            });
+        return;
+    }
 
-                size_t remaining = content_length;
-                while (remaining > 0 && file) {
-                    size_t to_read = std::min(remaining, buffer.size());
-                    file.read(buffer.data(), to_read);
-                    size_t actually_read = file.gcount();
+    auto body = std::make_shared<MultipartBody>(ranges, mime_type, makeBoundary());
+    res.set_content_provider(
+        body->layout.contentLength(), "multipart/byteranges; boundary=" + body->boundary,
+        [body, writer](size_t offset, size_t length, httplib::DataSink& sink) {
+            char scratch[MultipartByteRanges::MAX_PART_HEADER];
+            auto segment = body->layout.locate(offset, scratch);
+            if (segment.length == 0) {
+                return false;
+            }
 
-                    content.append(buffer.data(), actually_read);
-                    remaining -= actually_read;
+            size_t to_write = static_cast<size_t>(std::min<uint64_t>(length, segment.length));
+            if (segment.text) {
+                return sink.write(segment.text, to_write);
+            }
+            return writer(segment.file_offset, to_write, sink);
+        });
+}
 
-                    if (actually_read < to_read) break;
-                }
+RouteHandler::FileWriter RouteHandler::makeFileWriter(std::shared_ptr<FileHandle> file) {
+    switch (config_.stream_read_mode) {
+        case StreamReadMode::BLOCK_CACHE:
+            return makeCachedWriter(file);
 
-                res.set_content(content, getMimeType(StringUtils::getFileExtension(full_path)));
-                return;
+        case StreamReadMode::ASYNC:
+            return makeAsyncWriter(file);
+
+        case StreamReadMode::MAPPED: {
+            auto mapping = file->mapping();
+            if (mapping) {
+                return makeMappedWriter(mapping);
             }
+            Logger::debug("Memory mapping failed, using buffered stream for: " + file->path());
+            break;
         }
+
+        case StreamReadMode::BUFFERED:
+            break;
     }
+    return makeBufferedWriter(file);
+}
+
+RouteHandler::FileWriter RouteHandler::makeMappedWriter(std::shared_ptr<MappedFile> mapping) {
+    // The body is written to the socket directly from the page cache,
+    // without a per-request heap copy
+    size_t chunk_size = config_.stream_buffer_size;
+    auto throttle = scan_throttle_;
+    return [mapping, chunk_size, throttle](size_t offset, size_t length, httplib::DataSink& sink) {
+        const char* data = mapping->data() + offset;
+        size_t size = std::min(length, chunk_size);
+        if (throttle) {
+            auto start = std::chrono::steady_clock::now();
+            prefault(data, size);
+            throttle->recordStreamRead(std::chrono::steady_clock::now() - start);
+        }
+        return sink.write(data, size);
+    };
+}
 
-    // Full file response
-    res.set_header("Content-Length", std::to_string(file_size));
+RouteHandler::FileWriter RouteHandler::makeBufferedWriter(std::shared_ptr<FileHandle> file) {
+    auto pool = buffer_pool_;
+    auto timeout = std::chrono::seconds(config_.write_timeout);
+    auto throttle = scan_throttle_;
+    return [file, pool, timeout, throttle](size_t offset, size_t length, httplib::DataSink& sink) {
+        // Wait for the socket before taking a buffer, so a slow client
+        // never pins memory that other streams could use
+        if (!sink.is_writable()) {
+            return false;
+        }
+
+        auto buffer = pool->acquire(timeout);
+        if (!buffer) {
+            Logger::warning("Timed out waiting for stream buffer budget");
+            return false;
+        }
 
-    std::string content((std::istreambuf_iterator<char>(file)),
-                       std::istreambuf_iterator<char>());
+        auto start = std::chrono::steady_clock::now();
+        long long bytes_read = file->read(buffer.data(), std::min(length, buffer.size()), offset);
+        if (throttle) {
+            throttle->recordStreamRead(std::chrono::steady_clock::now() - start);
+        }
+        if (bytes_read <= 0) {
+            return false;
+        }
 
-    res.set_content(content, getMimeType(StringUtils::getFileExtension(full_path)));
+        return sink.write(buffer.data(), static_cast<size_t>(bytes_read));
+    };
+}
+
+RouteHandler::FileWriter RouteHandler::makeCachedWriter(std::shared_ptr<FileHandle> file) {
+    auto cache = block_cache_;
+    auto throttle = scan_throttle_;
+    return [file, cache, throttle](size_t offset, size_t length, httplib::DataSink& sink) {
+        if (!sink.is_writable()) {
+            return false;
+        }
+
+        uint64_t block_index = offset / cache->blockSize();
+        auto start = std::chrono::steady_clock::now();
+        auto block = cache->get(*file, block_index);
+        if (throttle) {
+            throttle->recordStreamRead(std::chrono::steady_clock::now() - start);
+        }
+        size_t block_offset = offset - static_cast<size_t>(block_index * cache->blockSize());
+        if (!block || block_offset >= block->size) {
+            return false;
+        }
+
+        // The block is shared with every other viewer of this file
+        return sink.write(block->data.get() + block_offset, std::min(length, block->size - block_offset));
+    };
+}
+
+RouteHandler::FileWriter RouteHandler::makeAsyncWriter(std::shared_ptr<FileHandle> file) {
+    auto pipeline = std::make_shared<ReadPipeline>(async_engine_, buffer_pool_, file,
+                                                   config_.async_io_stream_depth,
+                                                   std::chrono::seconds(config_.write_timeout));
+    auto throttle = scan_throttle_;
+    return [pipeline, throttle](size_t offset, size_t length, httplib::DataSink& sink) {
+        if (!sink.is_writable()) {
+            return false;
+        }
+        // The pipeline calls back once the read is in; the time until then is
+        // what the stream waited for the disk
+        auto start = std::chrono::steady_clock::now();
+        return pipeline->write(offset, length, [&sink, &throttle, start](const char* data, size_t size) {
+            if (throttle) {
+                throttle->recordStreamRead(std::chrono::steady_clock::now() - start);
+            }
+            return sink.write(data, size);
+        });
+    };
+}
+
+void RouteHandler::handleMetrics(const httplib::Request&, httplib::Response& res) {
+    setCorsHeaders(res);
+
+    auto cache = block_cache_->stats();
+    auto read_ahead = read_ahead_->stats();
+    MetricSections sections = {
+        {"block_cache", {
+            {"hits", cache.hits},
+            {"misses", cache.misses},
+            {"evictions", cache.evictions},
+            {"read_errors", cache.read_errors},
+            {"cached_blocks", cache.cached_blocks},
+            {"cached_bytes", cache.cached_bytes},
+            {"capacity_bytes", cache.capacity_bytes},
+            {"block_size", block_cache_->blockSize()}
+        }},
+        {"stream_buffers", {
+            {"in_use", buffer_pool_->buffersInUse()},
+            {"max", buffer_pool_->maxBuffers()},
+            {"buffer_size", buffer_pool_->bufferSize()}
+        }},
+        {"file_cache", {
+            {"open_files", file_cache_->size()}
+        }},
+        {"read_ahead", {
+            {"sessions", read_ahead.sessions},
+            {"sequential_requests", read_ahead.sequential_requests},
+            {"seeks", read_ahead.seeks},
+            {"willneed_bytes", read_ahead.willneed_bytes},
+            {"dontneed_bytes", read_ahead.dontneed_bytes}
+        }}
+    };
+
+    auto scan = api_->getScanner()->lastScanStats();
+    sections.push_back({"library_scan", {
+        {"threads", scan.threads},
+        {"directories", scan.directories},
+        {"wall_time_us", scan.wall_time_us},
+        {"busy_time_us", scan.busy_time_us},
+        {"parallelism_percent", static_cast<uint64_t>(scan.parallelism() * 100)},
+        {"directory_opens", scan.directory_opens},
+        {"directory_reads", scan.directory_reads},
+        {"stat_calls", scan.stat_calls},
+        {"entries", scan.entries},
+        {"typed_entries", scan.typed_entries}
+    }});
+
+    auto current = api_->snapshot();
+    sections.push_back({"library", {
+        {"years", current->library.yearCount()},
+        {"semesters", current->library.semesterCount()},
+        {"courses", current->library.courseCount()},
+        {"unscanned_courses", current->library.unscannedCourseCount()},
+        {"videos", current->library.videoCount()},
+        {"name_bytes", current->library.arenaSize()},
+        {"memory_bytes", current->library.memoryUsage()},
+        {"response_bytes", current->responseBytes()}
+    }});
+
+    auto library_body = current->libraryResponse();
+    auto variantSize = [&](ContentEncoding encoding) -> uint64_t {
+        return library_body && library_body->has(encoding) ? library_body->get(encoding).size() : 0;
+    };
+    sections.push_back({"compression", {
+        {"library_bytes", variantSize(ContentEncoding::IDENTITY)},
+        {"library_gzip_bytes", variantSize(ContentEncoding::GZIP)},
+        {"library_br_bytes", variantSize(ContentEncoding::BROTLI)},
+        {"library_zstd_bytes", variantSize(ContentEncoding::ZSTD)},
+        {"identity_responses", encoded_responses_[static_cast<size_t>(ContentEncoding::IDENTITY)].load()},
+        {"gzip_responses", encoded_responses_[static_cast<size_t>(ContentEncoding::GZIP)].load()},
+        {"br_responses", encoded_responses_[static_cast<size_t>(ContentEncoding::BROTLI)].load()},
+        {"zstd_responses", encoded_responses_[static_cast<size_t>(ContentEncoding::ZSTD)].load()},
+        {"saved_bytes", compression_saved_bytes_.load()}
+    }});
+
+    auto search = current->searchIndex().stats();
+    sections.push_back({"search", {
+        {"names", search.names},
+        {"trigrams", search.trigrams},
+        {"postings", search.postings},
+        {"index_bytes", search.memory_bytes},
+        {"build_time_us", search.build_time_us},
+        {"searches", searches_.load()},
+        {"search_time_us", search_time_us_.load()}
+    }});
+
+    auto changes = api_->changeLogStats();
+    sections.push_back({"library_changes", {
+        {"generation", current->generation},
+        {"entries", changes.entries},
+        {"oldest_generation", changes.oldest_generation},
+        {"recorded", changes.recorded},
+        {"truncated_generations", changes.truncated}
+    }});
+
+    if (scan_throttle_) {
+        auto throttle = scan_throttle_->stats();
+        sections.push_back({"scan_throttle", {
+            {"running_scans", throttle.running_scans},
+            {"scan_directories", throttle.scan_directories},
+            {"expected_directories", throttle.expected_directories},
+            {"ops", throttle.ops},
+            {"ops_per_second", throttle.ops_per_second},
+            {"budget_ops_per_second", throttle.budget},
+            {"paused_us", throttle.paused_us},
+            {"backoffs", throttle.backoffs},
+            {"stream_reads", throttle.stream_reads},
+            {"stream_read_latency_us", throttle.stream_read_latency_us}
+        }});
+    }
+
+    if (auto watcher = api_->getWatcher()) {
+        auto watch = watcher->stats();
+        sections.push_back({"library_watch", {
+            {"watches", watch.watches},
+            {"events", watch.events},
+            {"batches", watch.batches},
+            {"overflows", watch.overflows},
+            {"watch_failures", watch.watch_failures}
+        }});
+    }
+
+    if (auto poller = api_->getPoller()) {
+        auto poll = poller->stats();
+        sections.push_back({"library_poll", {
+            {"refreshes", poll.refreshes},
+            {"directories", poll.directories},
+            {"last_refresh_us", poll.last_refresh_us},
+            {"last_listings", poll.last_listings},
+            {"settling_courses", poll.settling_courses},
+            {"changed_paths", poll.changed_paths}
+        }});
+    }
+
+    auto admission = admission_->stats();
+    sections.push_back({"admission", {
+        {"active_streams", admission.active_streams},
+        {"max_streams", admission.max_streams},
+        {"rejected_streams", admission.rejected_streams},
+        {"shed_connections", admission.shed_connections},
+        {"shed_requests", admission.shed_requests},
+        {"dropped_connections", admission.dropped_connections},
+        {"busy_workers", admission.busy_workers},
+        {"closed_keep_alives", admission.closed_keep_alives}
+    }});
+
+    if (bandwidth_->enabled()) {
+        auto bandwidth = bandwidth_->stats();
+        sections.push_back({"bandwidth", {
+            {"open_streams", bandwidth.open_streams},
+            {"active_streams", bandwidth.active_streams},
+            {"fair_share_rate", bandwidth.fair_share_rate},
+            {"bytes_paced", bandwidth.bytes_paced},
+            {"throttled_writes", bandwidth.throttled_writes},
+            {"throttle_wait_ms", bandwidth.throttle_wait_ms}
+        }});
+    }
+
+    if (async_engine_) {
+        auto async_io = async_engine_->stats();
+        sections.push_back({"async_io", {
+            {"io_uring", std::string(async_engine_->backend()) == "io_uring" ? 1u : 0u},
+            {"submitted", async_io.submitted},
+            {"completed", async_io.completed},
+            {"failed", async_io.failed},
+            {"batches", async_io.batches},
+            {"in_flight", async_io.in_flight}
+        }});
+    }
+
+    res.set_content(JsonResponse::createMetricsResponse(sections), "application/json; charset=utf-8");
 }
 
 void RouteHandler::handleStatic(const httplib::Request& req, httplib::Response& res) {
@@ -184,9 +792,9 @@ void RouteHandler::handleStatic(const httplib::Request& req, httplib::Response&
         std::string filename = path.substr(8); // Remove "/static/"
 
         if (filename == "style.css") {
-            res.set_content(EmbeddedResources::getMainCss(), "text/css");
+            setEncodedContent(req, res, css_body_, "text/css");
         } else if (filename == "app.js") {
-            res.set_content(EmbeddedResources::getMainJs(), "application/javascript");
+            setEncodedContent(req, res, js_body_, "application/javascript");
         } else {
             res.status = 404;
             res.set_content("Not found", "text/plain");
@@ -208,13 +816,80 @@ std::string RouteHandler::getServerUrl(const httplib::Request& req) {
 void RouteHandler::setCorsHeaders(httplib::Response& res) {
     res.set_header("Access-Control-Allow-Origin", "*");
     res.set_header("Access-Control-Allow-Methods", "GET, POST, OPTIONS");
-    res.set_header("Access-Control-Allow-Headers", "Content-Type");
+    res.set_header("Access-Control-Allow-Headers", "Content-Type, If-None-Match");
+    res.set_header("Access-Control-Expose-Headers", "ETag");
+}
+
+void RouteHandler::setEncodedContent(const httplib::Request& req, httplib::Response& res,
+                                     std::shared_ptr<const EncodedBody> body, const char* content_type) {
+    ContentEncoding encoding = body->select(req.get_header_value("Accept-Encoding"));
+    const std::string* bytes = &body->get(encoding);
+
+    res.set_header("Vary", "Accept-Encoding");
+    if (encoding != ContentEncoding::IDENTITY) {
+        res.set_header("Content-Encoding", EncodedBody::name(encoding));
+        auto etag = res.headers.find("ETag");
+        if (etag != res.headers.end()) {
+            etag->second = encodedETag(etag->second, encoding);
+        }
+        compression_saved_bytes_ += body->identity().size() - bytes->size();
+    }
+    ++encoded_responses_[static_cast<size_t>(encoding)];
+
+    // Written straight from the shared copy, which the provider keeps alive
+    // until the response is sent
+    res.set_content_provider(bytes->size(), content_type,
+        [body, bytes](size_t offset, size_t length, httplib::DataSink& sink) {
+            return sink.write(bytes->data() + offset, length);
+        });
+}
+
+bool RouteHandler::isNotModified(const httplib::Request& req, httplib::Response& res) {
+    // These bodies only change when the library is rebuilt, so one validator
+    // covers every such endpoint
+    return isNotModified(req, res, api_->getETag(), api_->getLastModified());
+}
+
+bool RouteHandler::isNotModified(const httplib::Request& req, httplib::Response& res,
+                                 const std::string& etag, long long modified) {
+    // Clients must revalidate before reusing a copy
+    std::string last_modified = StringUtils::formatHttpDate(modified);
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("ETag", etag);
+    res.set_header("Last-Modified", last_modified);
+
+    bool not_modified;
+    auto if_none_match = req.headers.find("If-None-Match");
+    if (if_none_match != req.headers.end()) {
+        // A tag of any encoding of the body will do
+        not_modified = entityTagListMatches(if_none_match->second, etag);
+        for (auto encoding : {ContentEncoding::GZIP, ContentEncoding::BROTLI, ContentEncoding::ZSTD}) {
+            not_modified = not_modified ||
+                           entityTagListMatches(if_none_match->second, encodedETag(etag, encoding));
+        }
+    } else {
+        // If-Modified-Since only counts when no entity tag was sent, and holds
+        // while the body is no newer than the date (RFC 7232 3.3)
+        auto if_modified_since = req.headers.find("If-Modified-Since");
+        long long since = 0;
+        not_modified = if_modified_since != req.headers.end() &&
+                       StringUtils::parseHttpDate(if_modified_since->second, since) &&
+                       modified <= since;
+    }
+
+    if (not_modified) {
+        res.status = 304;
+    }
+    return not_modified;
 }
 
-void RouteHandler::setVideoHeaders(httplib::Response& res, const std::string& filename) {
-    res.set_header("Accept-Ranges", "bytes");
+void RouteHandler::setVideoHeaders(httplib::Response& res, const std::string& filename,
+                                   const std::string& etag, const std::string& last_modified) {
+    res.set_header("Accept-Ranges", config_.enable_range_requests ? "bytes" : "none");
     res.set_header("Cache-Control", "no-cache");
     res.set_header("Content-Disposition", "inline; filename=\"" + filename + "\"");
+    res.set_header("ETag", etag);
+    res.set_header("Last-Modified", last_modified);
 }
 
 std::string RouteHandler::getMimeType(const std::string& extension) {
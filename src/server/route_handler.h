@@ -1,41 +1,107 @@
 // src/server/route_handler.h
 #pragma once
+#include "utils/encoded_body.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <functional>
 #include <map>
 #include <memory>  // Added missing include
+#include <mutex>
 
 // Forward declaration for httplib
 namespace httplib {
     class Request;
     class Response;
+    class DataSink;
 }
 
 namespace utec {
 
     class VideoApi;
+    class MappedFile;
+    class FileHandle;
+    class FileHandleCache;
+    class BlockCache;
+    class ReadAheadTracker;
+    class AsyncReadEngine;
+    class BandwidthScheduler;
+    class AdmissionController;
+    class StreamBufferPool;
+    class ScanThrottle;
     struct ServerConfig;  // Forward declaration
 
     class RouteHandler {
     public:
-        explicit RouteHandler(std::shared_ptr<VideoApi> api, const std::string& root_path);
+        RouteHandler(std::shared_ptr<VideoApi> api, const std::string& root_path,
+                     const ServerConfig& config, std::shared_ptr<AdmissionController> admission);
 
         // Route handlers
         void handleIndex(const httplib::Request& req, httplib::Response& res);
         void handleLibrary(const httplib::Request& req, httplib::Response& res);
+        void handleLibraryChanges(const httplib::Request& req, httplib::Response& res);
         void handleVideo(const httplib::Request& req, httplib::Response& res);
+        void handleSearch(const httplib::Request& req, httplib::Response& res);
         void handleVideoStream(const httplib::Request& req, httplib::Response& res);
+        // httplib answers a Range header its own parser rejects (bytes=9-2,
+        // "bytes = 0-1") with 416 before routing. RFC 7233 says an invalid
+        // Range is ignored, so the error handler passes such /stream
+        // responses here to be served again; false for any other response
+        bool handleRejectedRange(const httplib::Request& req, httplib::Response& res);
         void handleStatic(const httplib::Request& req, httplib::Response& res);
+        void handleMetrics(const httplib::Request& req, httplib::Response& res);
 
         // Utility methods
         std::string getServerUrl(const httplib::Request& req);
 
     private:
+        // Writes up to length bytes of the file starting at an absolute offset
+        using FileWriter = std::function<bool(size_t offset, size_t length, httplib::DataSink& sink)>;
+
         std::shared_ptr<VideoApi> api_;
         std::string root_path_;
+        const ServerConfig& config_;
+        std::shared_ptr<StreamBufferPool> buffer_pool_;
+        std::shared_ptr<FileHandleCache> file_cache_;
+        std::shared_ptr<BlockCache> block_cache_;
+        std::shared_ptr<ReadAheadTracker> read_ahead_;
+        std::shared_ptr<AsyncReadEngine> async_engine_;
+        std::shared_ptr<BandwidthScheduler> bandwidth_;
+        std::shared_ptr<AdmissionController> admission_;
+        std::shared_ptr<ScanThrottle> scan_throttle_;  // told how long stream reads take
+
+        // The assets never change; the index page is built per Host, so a
+        // few of its versions are kept
+        std::shared_ptr<const EncodedBody> css_body_;
+        std::shared_ptr<const EncodedBody> js_body_;
+        std::mutex index_mutex_;
+        std::map<std::string, std::shared_ptr<const EncodedBody>> index_bodies_;
+
+        std::array<std::atomic<uint64_t>, 4> encoded_responses_{};  // by ContentEncoding
+        std::atomic<uint64_t> compression_saved_bytes_{0};
+        std::atomic<uint64_t> searches_{0};
+        std::atomic<uint64_t> search_time_us_{0};
+
+        // relative_path is still URL-encoded, as it appears after /stream/
+        void streamVideo(const httplib::Request& req, httplib::Response& res, std::string relative_path);
+
+        FileWriter makeFileWriter(std::shared_ptr<FileHandle> file);
+        FileWriter makeMappedWriter(std::shared_ptr<MappedFile> mapping);
+        FileWriter makeBufferedWriter(std::shared_ptr<FileHandle> file);
+        FileWriter makeCachedWriter(std::shared_ptr<FileHandle> file);
+        FileWriter makeAsyncWriter(std::shared_ptr<FileHandle> file);
 
         void setCorsHeaders(httplib::Response& res);
-        void setVideoHeaders(httplib::Response& res, const std::string& filename);
+        // Library-wide validators, for the library, changes and search
+        bool isNotModified(const httplib::Request& req, httplib::Response& res);
+        bool isNotModified(const httplib::Request& req, httplib::Response& res,
+                           const std::string& etag, long long modified);
+        // Sends the variant of a shared body that Accept-Encoding asks for
+        void setEncodedContent(const httplib::Request& req, httplib::Response& res,
+                               std::shared_ptr<const EncodedBody> body, const char* content_type);
+        void setVideoHeaders(httplib::Response& res, const std::string& filename,
+                             const std::string& etag, const std::string& last_modified);
         std::string getMimeType(const std::string& extension);
     };
 
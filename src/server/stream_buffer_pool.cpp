@@ -0,0 +1,80 @@
+// src/server/stream_buffer_pool.cpp
+#include "server/stream_buffer_pool.h"
+#include <algorithm>
+
+namespace utec {
+
+StreamBufferPool::Buffer::Buffer(StreamBufferPool* pool, std::unique_ptr<char[]> data, size_t size)
+    : pool_(pool), data_(std::move(data)), size_(size) {
+}
+
+StreamBufferPool::Buffer::Buffer(Buffer&& other) noexcept
+    : pool_(other.pool_), data_(std::move(other.data_)), size_(other.size_) {
+    other.pool_ = nullptr;
+    other.size_ = 0;
+}
+
+StreamBufferPool::Buffer& StreamBufferPool::Buffer::operator=(Buffer&& other) noexcept {
+    if (this != &other) {
+        if (pool_ && data_) {
+            pool_->release(std::move(data_));
+        }
+        pool_ = other.pool_;
+        data_ = std::move(other.data_);
+        size_ = other.size_;
+        other.pool_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+StreamBufferPool::Buffer::~Buffer() {
+    if (pool_ && data_) {
+        pool_->release(std::move(data_));
+    }
+}
+
+StreamBufferPool::StreamBufferPool(size_t buffer_size, size_t memory_budget)
+    : buffer_size_(buffer_size),
+      max_buffers_(std::max<size_t>(1, memory_budget / buffer_size)) {
+}
+
+StreamBufferPool::Buffer StreamBufferPool::acquire(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    bool ready = available_.wait_for(lock, timeout, [this]() {
+        return !free_.empty() || allocated_ < max_buffers_;
+    });
+    if (!ready) {
+        return Buffer();
+    }
+
+    std::unique_ptr<char[]> data;
+    if (!free_.empty()) {
+        data = std::move(free_.back());
+        free_.pop_back();
+    } else {
+        // Buffers are allocated lazily, so an idle server holds no stream memory
+        data.reset(new char[buffer_size_]);
+        ++allocated_;
+    }
+
+    ++in_use_;
+    return Buffer(this, std::move(data), buffer_size_);
+}
+
+size_t StreamBufferPool::buffersInUse() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_use_;
+}
+
+void StreamBufferPool::release(std::unique_ptr<char[]> data) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(std::move(data));
+        --in_use_;
+    }
+    available_.notify_one();
+}
+
+} // namespace utec
@@ -0,0 +1,58 @@
+// src/server/stream_buffer_pool.h
+#pragma once
+#include <cstddef>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace utec {
+
+    // Fixed-size read buffers shared by all buffered streams. The pool never
+    // allocates more than memory_budget bytes, so a stream that cannot get a
+    // buffer waits until a slower one hands its buffer back.
+    class StreamBufferPool {
+    public:
+        class Buffer {
+        public:
+            Buffer() = default;
+            Buffer(Buffer&& other) noexcept;
+            Buffer& operator=(Buffer&& other) noexcept;
+            ~Buffer();
+
+            explicit operator bool() const { return data_ != nullptr; }
+            char* data() const { return data_.get(); }
+            size_t size() const { return size_; }
+
+        private:
+            friend class StreamBufferPool;
+            Buffer(StreamBufferPool* pool, std::unique_ptr<char[]> data, size_t size);
+
+            StreamBufferPool* pool_ = nullptr;
+            std::unique_ptr<char[]> data_;
+            size_t size_ = 0;
+        };
+
+        StreamBufferPool(size_t buffer_size, size_t memory_budget);
+
+        // Blocks until a buffer is free; returns an empty buffer on timeout
+        Buffer acquire(std::chrono::milliseconds timeout);
+
+        size_t bufferSize() const { return buffer_size_; }
+        size_t maxBuffers() const { return max_buffers_; }
+        size_t buffersInUse() const;
+
+    private:
+        size_t buffer_size_;
+        size_t max_buffers_;
+        size_t allocated_ = 0;
+        size_t in_use_ = 0;
+        std::vector<std::unique_ptr<char[]>> free_;
+        mutable std::mutex mutex_;
+        std::condition_variable available_;
+
+        void release(std::unique_ptr<char[]> data);
+    };
+
+} // namespace utec
@@ -0,0 +1,232 @@
+// src/utils/encoded_body.cpp
+#include "utils/encoded_body.h"
+#include "utils/string_utils.h"
+#include <cctype>
+
+#ifdef UTEC_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef UTEC_HAVE_BROTLI
+#include <brotli/encode.h>
+#endif
+#ifdef UTEC_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace utec {
+
+namespace {
+
+// Bodies are compressed once per library version, so the levels favour size
+constexpr int GZIP_LEVEL = 9;
+constexpr int BROTLI_QUALITY = 9;  // 10 and 11 are several times slower for ~3% less
+constexpr int ZSTD_LEVEL = 15;
+
+// Headers and framing would outweigh the savings
+constexpr size_t MIN_COMPRESS_SIZE = 256;
+
+bool compressGzip(const std::string& input, std::string& output) {
+#ifdef UTEC_HAVE_ZLIB
+    z_stream stream{};
+    // 16 + MAX_WBITS asks for the gzip wrapper instead of raw zlib
+    if (deflateInit2(&stream, GZIP_LEVEL, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    output.resize(deflateBound(&stream, static_cast<uLong>(input.size())));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    stream.avail_out = static_cast<uInt>(output.size());
+    int result = deflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+    return result == Z_STREAM_END;
+#else
+    (void)input;
+    (void)output;
+    return false;
+#endif
+}
+
+bool compressBrotli(const std::string& input, std::string& output) {
+#ifdef UTEC_HAVE_BROTLI
+    size_t size = BrotliEncoderMaxCompressedSize(input.size());
+    if (size == 0) {
+        return false;
+    }
+    output.resize(size);
+    if (!BrotliEncoderCompress(BROTLI_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, input.size(),
+                               reinterpret_cast<const uint8_t*>(input.data()), &size,
+                               reinterpret_cast<uint8_t*>(&output[0]))) {
+        return false;
+    }
+    output.resize(size);
+    return true;
+#else
+    (void)input;
+    (void)output;
+    return false;
+#endif
+}
+
+bool compressZstd(const std::string& input, std::string& output) {
+#ifdef UTEC_HAVE_ZSTD
+    output.resize(ZSTD_compressBound(input.size()));
+    size_t size = ZSTD_compress(&output[0], output.size(), input.data(), input.size(), ZSTD_LEVEL);
+    if (ZSTD_isError(size)) {
+        return false;
+    }
+    output.resize(size);
+    return true;
+#else
+    (void)input;
+    (void)output;
+    return false;
+#endif
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string_view trim(std::string_view value) {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) value.remove_prefix(1);
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.remove_suffix(1);
+    return value;
+}
+
+// A q-value in thousandths; strtod would depend on the locale. Malformed
+// values count as 1, as if the parameter was absent
+int parseQuality(std::string_view value) {
+    if (value.empty() || (value[0] != '0' && value[0] != '1')) {
+        return 1000;
+    }
+    int quality = (value[0] - '0') * 1000;
+    if (value.size() > 1 && value[1] == '.') {
+        int scale = 100;
+        for (size_t i = 2; i < value.size() && i < 5 && std::isdigit(static_cast<unsigned char>(value[i])); ++i) {
+            quality += (value[i] - '0') * scale;
+            scale /= 10;
+        }
+    }
+    return quality > 1000 ? 1000 : quality;
+}
+
+} // namespace
+
+EncodedBody::EncodedBody(std::string body, bool compress) {
+    variants_[index(ContentEncoding::IDENTITY)] = std::move(body);
+    present_[index(ContentEncoding::IDENTITY)] = true;
+    const std::string& input = identity();
+    checksum_ = StringUtils::fnv1a(input);
+    compressed_ = compress;
+    if (!compress || input.size() < MIN_COMPRESS_SIZE) {
+        return;
+    }
+
+    auto add = [&](ContentEncoding encoding, bool (*compressor)(const std::string&, std::string&)) {
+        std::string output;
+        if (compressor(input, output) && output.size() < input.size()) {
+            output.shrink_to_fit();
+            variants_[index(encoding)] = std::move(output);
+            present_[index(encoding)] = true;
+        }
+    };
+    add(ContentEncoding::GZIP, compressGzip);
+    add(ContentEncoding::BROTLI, compressBrotli);
+    add(ContentEncoding::ZSTD, compressZstd);
+}
+
+ContentEncoding EncodedBody::select(std::string_view accept_encoding) const {
+    // -1 = not mentioned
+    std::array<int, COUNT> quality;
+    quality.fill(-1);
+    int any = -1;
+
+    while (!accept_encoding.empty()) {
+        size_t comma = accept_encoding.find(',');
+        std::string_view item = accept_encoding.substr(0, comma);
+        accept_encoding = comma == std::string_view::npos ? std::string_view() : accept_encoding.substr(comma + 1);
+
+        size_t semicolon = item.find(';');
+        std::string_view coding = trim(item.substr(0, semicolon));
+        int q = 1000;
+        if (semicolon != std::string_view::npos) {
+            std::string_view parameter = trim(item.substr(semicolon + 1));
+            if (parameter.size() > 2 && (parameter[0] == 'q' || parameter[0] == 'Q') && parameter[1] == '=') {
+                q = parseQuality(parameter.substr(2));
+            }
+        }
+
+        if (coding == "*") {
+            any = q;
+        } else if (equalsIgnoreCase(coding, "gzip") || equalsIgnoreCase(coding, "x-gzip")) {
+            quality[index(ContentEncoding::GZIP)] = q;
+        } else if (equalsIgnoreCase(coding, "br")) {
+            quality[index(ContentEncoding::BROTLI)] = q;
+        } else if (equalsIgnoreCase(coding, "zstd")) {
+            quality[index(ContentEncoding::ZSTD)] = q;
+        } else if (equalsIgnoreCase(coding, "identity")) {
+            quality[index(ContentEncoding::IDENTITY)] = q;
+        }
+    }
+
+    ContentEncoding best = ContentEncoding::IDENTITY;
+    int best_quality = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+        if (!present_[i]) {
+            continue;
+        }
+        // Unlisted codings take the wildcard's q; identity is acceptable unless excluded
+        int q = quality[i] >= 0 ? quality[i] : any >= 0 ? any : i == 0 ? 1 : 0;
+        if (q > best_quality || (q == best_quality && q > 0 && variants_[i].size() < get(best).size())) {
+            best = static_cast<ContentEncoding>(i);
+            best_quality = q;
+        }
+    }
+    return best;
+}
+
+size_t EncodedBody::memoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& variant : variants_) {
+        bytes += variant.capacity();
+    }
+    return bytes;
+}
+
+const char* EncodedBody::name(ContentEncoding encoding) {
+    switch (encoding) {
+        case ContentEncoding::GZIP:   return "gzip";
+        case ContentEncoding::BROTLI: return "br";
+        case ContentEncoding::ZSTD:   return "zstd";
+        case ContentEncoding::IDENTITY: break;
+    }
+    return "";
+}
+
+bool EncodedBody::available(ContentEncoding encoding) {
+    switch (encoding) {
+#ifdef UTEC_HAVE_ZLIB
+        case ContentEncoding::GZIP:   return true;
+#endif
+#ifdef UTEC_HAVE_BROTLI
+        case ContentEncoding::BROTLI: return true;
+#endif
+#ifdef UTEC_HAVE_ZSTD
+        case ContentEncoding::ZSTD:   return true;
+#endif
+        case ContentEncoding::IDENTITY: return true;
+        default: return false;
+    }
+}
+
+} // namespace utec
@@ -0,0 +1,49 @@
+// src/utils/encoded_body.h
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace utec {
+
+    enum class ContentEncoding { IDENTITY, GZIP, BROTLI, ZSTD };
+
+    // A response body together with its compressed variants, all built when
+    // the body is created so serving it never compresses anything. Encoders
+    // missing from the build are skipped, and a variant is only kept when
+    // it is smaller than the body.
+    class EncodedBody {
+    public:
+        EncodedBody(std::string body, bool compress);
+
+        bool has(ContentEncoding encoding) const { return present_[index(encoding)]; }
+        const std::string& get(ContentEncoding encoding) const { return variants_[index(encoding)]; }
+        const std::string& identity() const { return variants_[0]; }
+        // Of the body, for a validator that follows its content
+        uint64_t checksum() const { return checksum_; }
+        // Built with compress, whether or not a variant turned out smaller
+        bool compressed() const { return compressed_; }
+
+        // The smallest variant the Accept-Encoding value allows, by q-value
+        // first; IDENTITY for an empty header
+        ContentEncoding select(std::string_view accept_encoding) const;
+
+        size_t memoryUsage() const;  // bytes of every variant
+
+        // The Content-Encoding token; empty for IDENTITY
+        static const char* name(ContentEncoding encoding);
+        static bool available(ContentEncoding encoding);  // built with the encoder
+
+    private:
+        static constexpr size_t COUNT = 4;
+        static size_t index(ContentEncoding encoding) { return static_cast<size_t>(encoding); }
+
+        std::array<std::string, COUNT> variants_;
+        std::array<bool, COUNT> present_{};
+        uint64_t checksum_ = 0;
+        bool compressed_ = false;
+    };
+
+} // namespace utec
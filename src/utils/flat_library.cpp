@@ -0,0 +1,366 @@
+// src/utils/flat_library.cpp
+#include "utils/flat_library.h"
+#include "utils/string_utils.h"
+#include <functional>
+#include <stdexcept>
+
+namespace utec {
+
+namespace {
+
+template <typename T>
+size_t capacityBytes(const std::vector<T>& values) {
+    return values.capacity() * sizeof(T);
+}
+
+} // namespace
+
+FlatLibrary::FlatLibrary(const std::string& root_path) : root_path_(root_path) {
+}
+
+FlatLibrary::FlatLibrary(const std::string& root_path, const VideoLibrary& library) : root_path_(root_path) {
+    size_t semester_count = 0;
+    size_t course_count = 0;
+    size_t video_count = 0;
+    for (const auto& year : library) {
+        semester_count += year.semesters.size();
+        for (const auto& semester : year.semesters) {
+            course_count += semester.courses.size();
+            for (const auto& course : semester.courses) {
+                video_count += course.videos.size();
+            }
+        }
+    }
+
+    year_names_.reserve(library.size());
+    year_first_semester_.reserve(library.size());
+    semester_names_.reserve(semester_count);
+    semester_years_.reserve(semester_count);
+    semester_first_course_.reserve(semester_count);
+    course_directories_.reserve(course_count);
+    course_names_.reserve(course_count);
+    course_semesters_.reserve(course_count);
+    course_first_video_.reserve(course_count);
+    course_mtimes_.reserve(course_count);
+    course_scanned_.reserve(course_count);
+    video_names_.reserve(video_count);
+    video_courses_.reserve(video_count);
+    video_sizes_.reserve(video_count);
+
+    for (const auto& year : library) {
+        addYear(year.year);
+        for (const auto& semester : year.semesters) {
+            addSemester(semester.name);
+            for (const auto& course : semester.courses) {
+                addCourse(StringUtils::getBaseName(course.path), course.mtime, course.scanned);
+                for (const auto& video : course.videos) {
+                    addVideo(video.name, video.size);
+                }
+            }
+        }
+    }
+    finish();
+}
+
+void FlatLibrary::addYear(std::string_view name) {
+    year_names_.push_back(intern(name));
+    year_first_semester_.push_back(static_cast<Index>(semesterCount()));
+}
+
+void FlatLibrary::addSemester(std::string_view name) {
+    semester_names_.push_back(intern(name));
+    semester_years_.push_back(static_cast<Index>(yearCount() - 1));
+    semester_first_course_.push_back(static_cast<Index>(courseCount()));
+}
+
+void FlatLibrary::addCourse(std::string_view directory, int64_t mtime, bool scanned) {
+    Name directory_name = intern(directory);
+    course_directories_.push_back(directory_name);
+
+    // Underscores are shown as spaces; most names have none and share the slice
+    if (directory.find('_') == std::string_view::npos) {
+        course_names_.push_back(directory_name);
+    } else {
+        course_names_.push_back(intern(StringUtils::replaceAll(std::string(directory), "_", " ")));
+    }
+
+    course_semesters_.push_back(static_cast<Index>(semesterCount() - 1));
+    course_first_video_.push_back(static_cast<Index>(videoCount()));
+    course_mtimes_.push_back(mtime);
+    course_scanned_.push_back(scanned ? 1 : 0);
+    if (!scanned) {
+        ++unscanned_courses_;
+    }
+}
+
+void FlatLibrary::addVideo(std::string_view name, uint64_t size) {
+    video_names_.push_back(intern(name));
+    video_courses_.push_back(static_cast<Index>(courseCount() - 1));
+    video_sizes_.push_back(size);
+}
+
+void FlatLibrary::reuseNames(const FlatLibrary& base) {
+    // A copy is mostly base again
+    year_names_.reserve(base.yearCount());
+    year_first_semester_.reserve(base.yearCount());
+    semester_names_.reserve(base.semesterCount());
+    semester_years_.reserve(base.semesterCount());
+    semester_first_course_.reserve(base.semesterCount());
+    course_directories_.reserve(base.courseCount());
+    course_names_.reserve(base.courseCount());
+    course_semesters_.reserve(base.courseCount());
+    course_first_video_.reserve(base.courseCount());
+    course_mtimes_.reserve(base.courseCount());
+    course_scanned_.reserve(base.courseCount());
+    video_names_.reserve(base.videoCount());
+    video_courses_.reserve(base.videoCount());
+    video_sizes_.reserve(base.videoCount());
+
+    if (base.arena_.size() > 2 * base.unique_arena_size_) {
+        return;
+    }
+    arena_ = base.arena_;
+    reused_arena_ = &base.arena_;
+    unique_arena_size_ = base.unique_arena_size_;
+}
+
+void FlatLibrary::copyCourses(const FlatLibrary& base, Index begin, Index end) {
+    // With base's arena, base's slices are valid here as they are
+    bool same_arena = reused_arena_ == &base.arena_;
+    for (Index c = begin; c < end; ++c) {
+        if (same_arena) {
+            course_directories_.push_back(base.course_directories_[c]);
+            course_names_.push_back(base.course_names_[c]);
+        } else {
+            // The display name is interned as it is, not derived again
+            course_directories_.push_back(intern(base.courseDirectory(c)));
+            course_names_.push_back(intern(base.courseName(c)));
+        }
+        course_semesters_.push_back(static_cast<Index>(semesterCount() - 1));
+        course_first_video_.push_back(static_cast<Index>(videoCount()));
+        course_mtimes_.push_back(base.courseMtime(c));
+        course_scanned_.push_back(base.courseScanned(c) ? 1 : 0);
+        if (!base.courseScanned(c)) {
+            ++unscanned_courses_;
+        }
+
+        Index first = base.videoBegin(c);
+        Index last = base.videoEnd(c);
+        if (same_arena) {
+            video_names_.insert(video_names_.end(), base.video_names_.begin() + first,
+                                base.video_names_.begin() + last);
+            video_courses_.insert(video_courses_.end(), last - first, static_cast<Index>(courseCount() - 1));
+            video_sizes_.insert(video_sizes_.end(), base.video_sizes_.begin() + first,
+                                base.video_sizes_.begin() + last);
+        } else {
+            for (Index v = first; v < last; ++v) {
+                addVideo(base.videoName(v), base.videoSize(v));
+            }
+        }
+    }
+}
+
+void FlatLibrary::finish() {
+    if (!reused_arena_) {
+        unique_arena_size_ = arena_.size();
+    }
+    reused_arena_ = nullptr;
+    std::unordered_multimap<size_t, Name>().swap(interned_);
+    arena_.shrink_to_fit();
+    year_names_.shrink_to_fit();
+    year_first_semester_.shrink_to_fit();
+    semester_names_.shrink_to_fit();
+    semester_years_.shrink_to_fit();
+    semester_first_course_.shrink_to_fit();
+    course_directories_.shrink_to_fit();
+    course_names_.shrink_to_fit();
+    course_semesters_.shrink_to_fit();
+    course_first_video_.shrink_to_fit();
+    course_mtimes_.shrink_to_fit();
+    course_scanned_.shrink_to_fit();
+    video_names_.shrink_to_fit();
+    video_courses_.shrink_to_fit();
+    video_sizes_.shrink_to_fit();
+}
+
+FlatLibrary::Name FlatLibrary::intern(std::string_view value) {
+    // The copied arena has base's names at the same offsets
+    std::less<const char*> before;
+    if (reused_arena_ && !before(value.data(), reused_arena_->data()) &&
+        !before(reused_arena_->data() + reused_arena_->size(), value.data() + value.size())) {
+        return Name{static_cast<uint32_t>(value.data() - reused_arena_->data()),
+                    static_cast<uint32_t>(value.size())};
+    }
+
+    size_t hash = std::hash<std::string_view>()(value);
+    auto range = interned_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (name(it->second) == value) {
+            return it->second;
+        }
+    }
+
+    if (arena_.size() + value.size() > UINT32_MAX) {
+        throw std::length_error("Library names exceed the arena limit");
+    }
+    Name slice{static_cast<uint32_t>(arena_.size()), static_cast<uint32_t>(value.size())};
+    arena_.append(value);
+    interned_.emplace(hash, slice);
+    return slice;
+}
+
+int FlatLibrary::compareCourses(const FlatLibrary& a, Index a_course, const FlatLibrary& b, Index b_course) {
+    Index a_semester = a.courseSemester(a_course);
+    Index b_semester = b.courseSemester(b_course);
+    if (int order = a.yearName(a.semesterYear(a_semester)).compare(b.yearName(b.semesterYear(b_semester)))) {
+        return order;
+    }
+    if (int order = a.semesterName(a_semester).compare(b.semesterName(b_semester))) {
+        return order;
+    }
+    return a.courseDirectory(a_course).compare(b.courseDirectory(b_course));
+}
+
+FlatLibrary FlatLibrary::merge(const FlatLibrary& base, const FlatLibrary& current, const FlatLibrary& changes) {
+    FlatLibrary library(current.rootPath());
+    library.reuseNames(current);
+
+    // The three course lists are in path order, so one pass lines them up;
+    // years and semesters follow from the courses, as none is ever empty
+    Index b = 0;
+    Index c = 0;
+    Index n = 0;
+    const FlatLibrary* last = nullptr;
+    Index last_course = 0;
+    auto append = [&](const FlatLibrary& from, Index course) {
+        Index semester = from.courseSemester(course);
+        bool new_year = !last || last->yearName(last->semesterYear(last->courseSemester(last_course))) !=
+                                     from.yearName(from.semesterYear(semester));
+        if (new_year) {
+            library.addYear(from.yearName(from.semesterYear(semester)));
+        }
+        if (new_year || last->semesterName(last->courseSemester(last_course)) != from.semesterName(semester)) {
+            library.addSemester(from.semesterName(semester));
+        }
+        library.copyCourses(from, course, course + 1);
+        last = &from;
+        last_course = course;
+    };
+
+    while (c < current.courseCount() || n < changes.courseCount()) {
+        // The first course in path order among the three lists
+        const FlatLibrary* first = c < current.courseCount() ? &current : &changes;
+        Index first_course = c < current.courseCount() ? c : n;
+        if (n < changes.courseCount() && compareCourses(changes, n, *first, first_course) < 0) {
+            first = &changes;
+            first_course = n;
+        }
+        if (b < base.courseCount() && compareCourses(base, b, *first, first_course) < 0) {
+            first = &base;
+            first_course = b;
+        }
+
+        bool in_base = b < base.courseCount() && compareCourses(base, b, *first, first_course) == 0;
+        bool in_current = c < current.courseCount() && compareCourses(current, c, *first, first_course) == 0;
+        bool in_changes = n < changes.courseCount() && compareCourses(changes, n, *first, first_course) == 0;
+
+        // mtimes count here: a listing with a newer one is the fresher read
+        bool changed = in_base != in_changes ||
+                       (in_base && (!sameCourse(base, b, changes, n) || base.courseMtime(b) != changes.courseMtime(n)));
+        if (changed ? in_changes : in_current) {
+            append(changed ? changes : current, changed ? n : c);
+        }
+
+        b += in_base ? 1 : 0;
+        c += in_current ? 1 : 0;
+        n += in_changes ? 1 : 0;
+    }
+    library.finish();
+    return library;
+}
+
+bool FlatLibrary::sameCourse(const FlatLibrary& a, Index a_course, const FlatLibrary& b, Index b_course) {
+    if (a.courseScanned(a_course) != b.courseScanned(b_course) ||
+        a.courseVideoCount(a_course) != b.courseVideoCount(b_course)) {
+        return false;
+    }
+    for (Index v = a.videoBegin(a_course), w = b.videoBegin(b_course); v < a.videoEnd(a_course); ++v, ++w) {
+        if (a.videoName(v) != b.videoName(w) || a.videoSize(v) != b.videoSize(w)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Paths are built from the names, so equal names and parents mean equal paths
+bool FlatLibrary::sameVideos(const FlatLibrary& a, const FlatLibrary& b) {
+    if (a.yearCount() != b.yearCount() || a.semesterCount() != b.semesterCount() ||
+        a.courseCount() != b.courseCount() || a.videoCount() != b.videoCount() ||
+        a.rootPath() != b.rootPath()) {
+        return false;
+    }
+    for (Index y = 0; y < a.yearCount(); ++y) {
+        if (a.yearName(y) != b.yearName(y) || a.semesterBegin(y) != b.semesterBegin(y)) {
+            return false;
+        }
+    }
+    for (Index s = 0; s < a.semesterCount(); ++s) {
+        if (a.semesterName(s) != b.semesterName(s) || a.courseBegin(s) != b.courseBegin(s)) {
+            return false;
+        }
+    }
+    for (Index c = 0; c < a.courseCount(); ++c) {
+        if (a.courseDirectory(c) != b.courseDirectory(c) || a.videoBegin(c) != b.videoBegin(c) ||
+            a.courseScanned(c) != b.courseScanned(c)) {
+            return false;
+        }
+    }
+    for (Index v = 0; v < a.videoCount(); ++v) {
+        if (a.videoName(v) != b.videoName(v) || a.videoSize(v) != b.videoSize(v)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t FlatLibrary::memoryUsage() const {
+    return sizeof(*this) + arena_.capacity() +
+           capacityBytes(year_names_) + capacityBytes(year_first_semester_) +
+           capacityBytes(semester_names_) + capacityBytes(semester_years_) +
+           capacityBytes(semester_first_course_) +
+           capacityBytes(course_directories_) + capacityBytes(course_names_) +
+           capacityBytes(course_semesters_) + capacityBytes(course_first_video_) +
+           capacityBytes(course_mtimes_) + capacityBytes(course_scanned_) +
+           capacityBytes(video_names_) + capacityBytes(video_courses_) + capacityBytes(video_sizes_);
+}
+
+std::string FlatLibrary::courseRelativePath(Index course) const {
+    Index semester = courseSemester(course);
+    std::string path;
+    path.reserve(yearName(semesterYear(semester)).size() + semesterName(semester).size() +
+                 courseDirectory(course).size() + 2);
+    path.append(yearName(semesterYear(semester))).append(1, '/');
+    path.append(semesterName(semester)).append(1, '/');
+    path.append(courseDirectory(course));
+    return path;
+}
+
+std::string FlatLibrary::coursePath(Index course) const {
+    return root_path_ + "/" + courseRelativePath(course);
+}
+
+std::string FlatLibrary::videoRelativePath(Index video) const {
+    std::string path = courseRelativePath(videoCourse(video));
+    path.append(1, '/').append(videoName(video));
+    return path;
+}
+
+std::string FlatLibrary::videoPath(Index video) const {
+    return root_path_ + "/" + videoRelativePath(video);
+}
+
+std::string FlatLibrary::videoExtension(Index video) const {
+    return StringUtils::getFileExtension(std::string(videoName(video)));
+}
+
+} // namespace utec
@@ -0,0 +1,137 @@
+// src/utils/flat_library.h
+#pragma once
+#include "utils/types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace utec {
+
+    // The library as parallel arrays, one set per level. Each entry holds the
+    // index of its parent and the first of its children, which are stored
+    // contiguously; names are offsets into a single arena that keeps every
+    // distinct name once. Paths are not stored but rebuilt from the names.
+    class FlatLibrary {
+    public:
+        using Index = uint32_t;
+        static constexpr Index npos = static_cast<Index>(-1);
+
+        FlatLibrary() = default;
+        explicit FlatLibrary(const std::string& root_path);
+        FlatLibrary(const std::string& root_path, const VideoLibrary& library);
+
+        // Entries are appended in library order, each one under the entry
+        // added last on the level above it
+        void addYear(std::string_view name);
+        void addSemester(std::string_view name);
+        // An unscanned course is known by its directory only; its videos are
+        // listed later and it may still turn out to be empty
+        void addCourse(std::string_view directory, int64_t mtime, bool scanned = true);
+        void addVideo(std::string_view name, uint64_t size);
+        // Releases the lookup table used to share names and spare capacity
+        void finish();
+
+        // For building a copy of base with some entries replaced: names that
+        // are views into base's arena keep their slice instead of being
+        // stored again. Names only the replaced entries used stay behind,
+        // until they could make up half the arena and the copy interns
+        // everything afresh. base must outlive the build, up to finish()
+        void reuseNames(const FlatLibrary& base);
+        // Appends base's courses [begin, end) and their videos under the
+        // semester added last
+        void copyCourses(const FlatLibrary& base, Index begin, Index end);
+
+        // Courses in path order: by year, then semester, then directory
+        static int compareCourses(const FlatLibrary& a, Index a_course, const FlatLibrary& b, Index b_course);
+        // For two versions built from base, each with some courses rescanned:
+        // current with every course changes added, removed or altered since
+        // base. A course both altered is taken from changes
+        static FlatLibrary merge(const FlatLibrary& base, const FlatLibrary& current, const FlatLibrary& changes);
+
+        // Same listing state and videos (names and sizes); mtimes are ignored
+        static bool sameCourse(const FlatLibrary& a, Index a_course, const FlatLibrary& b, Index b_course);
+        // What clients see: the same entries in the same places, with the
+        // same listing state and videos; mtimes are ignored
+        static bool sameVideos(const FlatLibrary& a, const FlatLibrary& b);
+
+        const std::string& rootPath() const { return root_path_; }
+        size_t yearCount() const { return year_names_.size(); }
+        size_t semesterCount() const { return semester_names_.size(); }
+        size_t courseCount() const { return course_directories_.size(); }
+        size_t videoCount() const { return video_names_.size(); }
+        size_t unscannedCourseCount() const { return unscanned_courses_; }
+        size_t arenaSize() const { return arena_.size(); }
+        size_t memoryUsage() const;  // bytes held by the arrays and the arena
+
+        std::string_view yearName(Index year) const { return name(year_names_[year]); }
+        Index semesterBegin(Index year) const { return year_first_semester_[year]; }
+        Index semesterEnd(Index year) const { return childEnd(year_first_semester_, year, semesterCount()); }
+
+        std::string_view semesterName(Index semester) const { return name(semester_names_[semester]); }
+        Index semesterYear(Index semester) const { return semester_years_[semester]; }
+        Index courseBegin(Index semester) const { return semester_first_course_[semester]; }
+        Index courseEnd(Index semester) const { return childEnd(semester_first_course_, semester, courseCount()); }
+
+        std::string_view courseDirectory(Index course) const { return name(course_directories_[course]); }
+        std::string_view courseName(Index course) const { return name(course_names_[course]); }  // for display
+        Index courseSemester(Index course) const { return course_semesters_[course]; }
+        int64_t courseMtime(Index course) const { return course_mtimes_[course]; }
+        bool courseScanned(Index course) const { return course_scanned_[course] != 0; }
+        Index videoBegin(Index course) const { return course_first_video_[course]; }
+        Index videoEnd(Index course) const { return childEnd(course_first_video_, course, videoCount()); }
+        size_t courseVideoCount(Index course) const { return videoEnd(course) - videoBegin(course); }
+
+        std::string_view videoName(Index video) const { return name(video_names_[video]); }
+        Index videoCourse(Index video) const { return video_courses_[video]; }
+        uint64_t videoSize(Index video) const { return video_sizes_[video]; }
+
+        // year/semester/course below the root, and the same under root_path
+        std::string courseRelativePath(Index course) const;
+        std::string coursePath(Index course) const;
+        std::string videoRelativePath(Index video) const;
+        std::string videoPath(Index video) const;
+        std::string videoExtension(Index video) const;
+
+    private:
+        struct Name {
+            uint32_t offset = 0;
+            uint32_t length = 0;
+        };
+
+        std::string root_path_;
+        std::string arena_;
+        std::unordered_multimap<size_t, Name> interned_;  // name hash -> arena slice, while building
+        const std::string* reused_arena_ = nullptr;        // base's arena, while building a copy
+        size_t unique_arena_size_ = 0;                     // arena size when every name was stored once
+
+        std::vector<Name> year_names_;
+        std::vector<Index> year_first_semester_;
+
+        std::vector<Name> semester_names_;
+        std::vector<Index> semester_years_;
+        std::vector<Index> semester_first_course_;
+
+        std::vector<Name> course_directories_;
+        std::vector<Name> course_names_;
+        std::vector<Index> course_semesters_;
+        std::vector<Index> course_first_video_;
+        std::vector<int64_t> course_mtimes_;
+        std::vector<uint8_t> course_scanned_;
+        size_t unscanned_courses_ = 0;
+
+        std::vector<Name> video_names_;
+        std::vector<Index> video_courses_;
+        std::vector<uint64_t> video_sizes_;
+
+        std::string_view name(Name slice) const { return std::string_view(arena_.data() + slice.offset, slice.length); }
+        Name intern(std::string_view value);
+
+        static Index childEnd(const std::vector<Index>& first, Index entry, size_t total) {
+            return entry + 1 < first.size() ? first[entry + 1] : static_cast<Index>(total);
+        }
+    };
+
+} // namespace utec
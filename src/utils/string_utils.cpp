@@ -4,6 +4,9 @@
 #include <sstream>
 #include <cctype>
 #include <iomanip>  // Added missing include
+#include <ctime>
+#include <cstdio>
+#include <cstring>
 
 namespace utec {
 
@@ -109,4 +112,86 @@ std::string StringUtils::getBaseName(const std::string& path) {
     return path.substr(pos + 1);
 }
 
-} // namespace utec
\ No newline at end of file
+std::string StringUtils::formatHttpDate(long long unix_seconds) {
+    // IMF-fixdate, built by hand so the output does not depend on the locale
+    static const char* const days[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+    static const char* const months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                         "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+    std::time_t time = static_cast<std::time_t>(unix_seconds);
+    std::tm tm{};
+#ifdef _WIN32
+    gmtime_s(&tm, &time);
+#else
+    gmtime_r(&time, &tm);
+#endif
+
+    std::ostringstream date;
+    date << days[tm.tm_wday] << ", "
+         << std::setfill('0') << std::setw(2) << tm.tm_mday << " "
+         << months[tm.tm_mon] << " " << (tm.tm_year + 1900) << " "
+         << std::setw(2) << tm.tm_hour << ":" << std::setw(2) << tm.tm_min << ":"
+         << std::setw(2) << tm.tm_sec << " GMT";
+    return date.str();
+}
+
+bool StringUtils::parseHttpDate(const std::string& date, long long& unix_seconds) {
+    // IMF-fixdate "Sun, 06 Nov 1994 08:49:37 GMT", the obsolete RFC 850
+    // "Sunday, 06-Nov-94 08:49:37 GMT" and asctime "Sun Nov  6 08:49:37 1994"
+    // (RFC 7231 7.1.1.1); the day name is not checked
+    static const char* const months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                         "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    char month_name[4] = {};
+    int day = 0, year = 0, hour = 0, minute = 0, second = 0;
+    int consumed = -1;
+
+    const char* text = date.c_str();
+    const char* comma = std::strchr(text, ',');
+    if (comma != nullptr) {
+        if (std::sscanf(comma + 1, " %2d%*[ -]%3[A-Za-z]%*[ -]%4d %2d:%2d:%2d GMT%n",
+                        &day, month_name, &year, &hour, &minute, &second, &consumed) != 6) {
+            return false;
+        }
+        text = comma + 1;
+        // A two-digit year that looks more than 50 years ahead is in the past
+        if (year < 100) {
+            year += year < 70 ? 2000 : 1900;
+        }
+    } else if (std::sscanf(text, "%*3[A-Za-z] %3[A-Za-z] %2d %2d:%2d:%2d %4d%n",
+                           month_name, &day, &hour, &minute, &second, &year, &consumed) != 6) {
+        return false;
+    }
+    if (consumed < 0 || text[consumed] != '\0') {
+        return false;
+    }
+
+    int month = 0;
+    while (month < 12 && std::strcmp(months[month], month_name) != 0) {
+        ++month;
+    }
+    if (month == 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return false;
+    }
+
+    // Days since 1970-01-01 in the proleptic Gregorian calendar, without
+    // timegm, which Windows lacks
+    long long y = month < 2 ? year - 1 : year;
+    long long era = (y >= 0 ? y : y - 399) / 400;
+    long long year_of_era = y - era * 400;
+    long long day_of_year = (153 * (month < 2 ? month + 10 : month - 2) + 2) / 5 + day - 1;
+    long long day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    long long days = era * 146097 + day_of_era - 719468;
+
+    unix_seconds = days * 86400 + hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+uint64_t StringUtils::fnv1a(std::string_view data) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : data) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // namespace utec
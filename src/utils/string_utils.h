@@ -1,6 +1,8 @@
 // src/utils/string_utils.h
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace utec {
@@ -17,6 +19,11 @@ namespace utec {
         static bool endsWith(const std::string& str, const std::string& suffix);
         static std::string getFileExtension(const std::string& filename);
         static std::string getBaseName(const std::string& path);
+        static std::string formatHttpDate(long long unix_seconds);
+        // Any of the three HTTP-date formats; false when date is none of them
+        static bool parseHttpDate(const std::string& date, long long& unix_seconds);
+        // 64-bit FNV-1a: the same for the same bytes in every run
+        static uint64_t fnv1a(std::string_view data);
     };
 
 } // namespace utec
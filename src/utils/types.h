@@ -1,5 +1,6 @@
 // src/utils/types.h
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
@@ -18,6 +19,8 @@ struct Course {
     std::string name;
     std::string path;
     std::vector<VideoFile> videos;
+    int64_t mtime = 0;  // directory mtime seen before the listing, 0 = recheck
+    bool scanned = true;  // false while a lazy scan has not listed the videos yet
 };
 
 struct Semester {
@@ -0,0 +1,106 @@
+// tests/flat_library_test.cpp
+#include "utils/flat_library.h"
+#include "test_support.h"
+#include <string>
+#include <vector>
+
+using namespace utec;
+
+namespace {
+
+struct TestCourse {
+    std::string year;
+    std::string semester;
+    std::string directory;
+    int64_t mtime;
+    std::vector<std::string> videos;  // sized by name length
+};
+
+FlatLibrary build(const std::vector<TestCourse>& courses) {
+    FlatLibrary library("/srv/videos");
+    const TestCourse* last = nullptr;
+    for (const auto& course : courses) {
+        if (!last || last->year != course.year) {
+            library.addYear(course.year);
+        }
+        if (!last || last->year != course.year || last->semester != course.semester) {
+            library.addSemester(course.semester);
+        }
+        library.addCourse(course.directory, course.mtime, !course.videos.empty());
+        for (const auto& video : course.videos) {
+            library.addVideo(video, video.size());
+        }
+        last = &course;
+    }
+    library.finish();
+    return library;
+}
+
+void testMergeTakesBothSides() {
+    FlatLibrary base = build({
+        {"2023", "Semester_2", "Algebra", 1, {"a.mp4"}},
+        {"2024", "Semester_1", "Algorithms", 1, {}},
+        {"2024", "Semester_1", "Databases", 1, {"db.mp4"}},
+        {"2024", "Semester_1", "Networks", 1, {"net.mp4"}},
+    });
+    // Another update listed Algorithms and added a semester
+    FlatLibrary current = build({
+        {"2023", "Semester_2", "Algebra", 1, {"a.mp4"}},
+        {"2024", "Semester_1", "Algorithms", 2, {"sort.mp4"}},
+        {"2024", "Semester_1", "Databases", 1, {"db.mp4"}},
+        {"2024", "Semester_1", "Networks", 1, {"net.mp4"}},
+        {"2024", "Semester_2", "Compilers", 2, {"parse.mp4"}},
+    });
+    // The rescan being merged removed 2023, changed Databases, added Graphics
+    // and removed Networks
+    FlatLibrary changes = build({
+        {"2024", "Semester_1", "Algorithms", 1, {}},
+        {"2024", "Semester_1", "Databases", 3, {"db.mp4", "sql.mp4"}},
+        {"2024", "Semester_1", "Graphics", 3, {"gl.mp4"}},
+    });
+
+    FlatLibrary expected = build({
+        {"2024", "Semester_1", "Algorithms", 2, {"sort.mp4"}},
+        {"2024", "Semester_1", "Databases", 3, {"db.mp4", "sql.mp4"}},
+        {"2024", "Semester_1", "Graphics", 3, {"gl.mp4"}},
+        {"2024", "Semester_2", "Compilers", 2, {"parse.mp4"}},
+    });
+    FlatLibrary merged = FlatLibrary::merge(base, current, changes);
+    CHECK(FlatLibrary::sameVideos(merged, expected));
+    CHECK_EQ(merged.unscannedCourseCount(), 0u);
+    CHECK_EQ(merged.courseMtime(1), 3);
+}
+
+void testMergeConflicts() {
+    FlatLibrary base = build({{"2024", "Semester_1", "Algorithms", 1, {"a.mp4"}}});
+    FlatLibrary current = build({{"2024", "Semester_1", "Algorithms", 2, {"a.mp4", "b.mp4"}}});
+
+    // Both changed the course: the rescan being merged wins
+    FlatLibrary changes = build({{"2024", "Semester_1", "Algorithms", 3, {"c.mp4"}}});
+    FlatLibrary merged = FlatLibrary::merge(base, current, changes);
+    CHECK(FlatLibrary::sameVideos(merged, changes));
+
+    // Only the mtime moved, which is still the fresher listing
+    changes = build({{"2024", "Semester_1", "Algorithms", 3, {"a.mp4"}}});
+    merged = FlatLibrary::merge(base, current, changes);
+    CHECK(FlatLibrary::sameVideos(merged, changes));
+
+    // Unchanged by the rescan: current is kept as it is
+    merged = FlatLibrary::merge(base, current, base);
+    CHECK(FlatLibrary::sameVideos(merged, current));
+    CHECK_EQ(merged.courseMtime(0), 2);
+
+    // Both removed it
+    FlatLibrary empty = build({});
+    merged = FlatLibrary::merge(base, empty, empty);
+    CHECK_EQ(merged.courseCount(), 0u);
+    CHECK_EQ(merged.yearCount(), 0u);
+}
+
+} // namespace
+
+int main() {
+    testMergeTakesBothSides();
+    testMergeConflicts();
+    return test::result("flat_library_test");
+}
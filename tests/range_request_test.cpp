@@ -0,0 +1,180 @@
+// tests/range_request_test.cpp
+#include "server/range_request.h"
+#include "test_support.h"
+#include <string>
+
+using namespace utec;
+
+namespace {
+
+using Status = RangeRequest::Status;
+
+void testSingleRanges() {
+    auto ranges = RangeRequest::parse("bytes=0-99", 1000);
+    CHECK(ranges.status() == Status::SATISFIABLE);
+    CHECK_EQ(ranges.count(), 1u);
+    CHECK_EQ(ranges[0].first, 0u);
+    CHECK_EQ(ranges[0].last, 99u);
+    CHECK_EQ(ranges[0].length(), 100u);
+
+    // The last position is clamped to the representation
+    ranges = RangeRequest::parse("bytes=900-5000", 1000);
+    CHECK(ranges.status() == Status::SATISFIABLE);
+    CHECK_EQ(ranges[0].last, 999u);
+
+    // Unit names are case-insensitive and whitespace around tokens is allowed
+    ranges = RangeRequest::parse("  Bytes = 10 - 19 ", 1000);
+    CHECK(ranges.status() == Status::SATISFIABLE);
+    CHECK_EQ(ranges[0].first, 10u);
+    CHECK_EQ(ranges[0].last, 19u);
+}
+
+void testSuffixRanges() {
+    auto ranges = RangeRequest::parse("bytes=-100", 1000);
+    CHECK(ranges.status() == Status::SATISFIABLE);
+    CHECK_EQ(ranges[0].first, 900u);
+    CHECK_EQ(ranges[0].last, 999u);
+
+    // A suffix longer than the representation means all of it
+    ranges = RangeRequest::parse("bytes=-5000", 1000);
+    CHECK(ranges.status() == Status::SATISFIABLE);
+    CHECK_EQ(ranges[0].first, 0u);
+    CHECK_EQ(ranges[0].last, 999u);
+
+    CHECK(RangeRequest::parse("bytes=-0", 1000).status() == Status::UNSATISFIABLE);
+    CHECK(RangeRequest::parse("bytes=-10", 0).status() == Status::UNSATISFIABLE);
+}
+
+void testOpenEndedRanges() {
+    auto ranges = RangeRequest::parse("bytes=400-", 1000);
+    CHECK(ranges.status() == Status::SATISFIABLE);
+    CHECK_EQ(ranges[0].first, 400u);
+    CHECK_EQ(ranges[0].last, 999u);
+
+    ranges = RangeRequest::parse("bytes=999-", 1000);
+    CHECK(ranges.status() == Status::SATISFIABLE);
+    CHECK_EQ(ranges[0].length(), 1u);
+
+    // First positions past the end saturate instead of wrapping
+    CHECK(RangeRequest::parse("bytes=99999999999999999999999-", 1000).status() == Status::UNSATISFIABLE);
+}
+
+void testCoalescing() {
+    // Sorted, and overlapping or adjacent ranges merged
+    auto ranges = RangeRequest::parse("bytes=500-599,0-99,100-199,550-700", 1000);
+    CHECK(ranges.status() == Status::SATISFIABLE);
+    CHECK_EQ(ranges.count(), 2u);
+    CHECK_EQ(ranges[0].first, 0u);
+    CHECK_EQ(ranges[0].last, 199u);
+    CHECK_EQ(ranges[1].first, 500u);
+    CHECK_EQ(ranges[1].last, 700u);
+
+    ranges = RangeRequest::parse("bytes=0-0,-1", 1000);
+    CHECK_EQ(ranges.count(), 2u);
+    CHECK_EQ(ranges[1].first, 999u);
+
+    // Empty list elements are allowed by the #rule
+    ranges = RangeRequest::parse("bytes=0-9,,20-29,", 1000);
+    CHECK_EQ(ranges.count(), 2u);
+
+    // Unsatisfiable members are dropped while others remain
+    ranges = RangeRequest::parse("bytes=5000-6000,0-9", 1000);
+    CHECK(ranges.status() == Status::SATISFIABLE);
+    CHECK_EQ(ranges.count(), 1u);
+}
+
+void testRangeCap() {
+    std::string header = "bytes=";
+    for (size_t i = 0; i < RangeRequest::MAX_RANGES; ++i) {
+        header += (i ? "," : "") + std::to_string(i * 10) + "-" + std::to_string(i * 10 + 1);
+    }
+    auto ranges = RangeRequest::parse(header, 1000);
+    CHECK(ranges.status() == Status::SATISFIABLE);
+    CHECK_EQ(ranges.count(), RangeRequest::MAX_RANGES);
+
+    header += ",500-501";
+    CHECK(RangeRequest::parse(header, 1000).status() == Status::IGNORED);
+}
+
+void testUnsatisfiable() {
+    // 416 with Content-Range: bytes */size; the size is what the handler reports
+    auto ranges = RangeRequest::parse("bytes=1000-1999", 1000);
+    CHECK(ranges.status() == Status::UNSATISFIABLE);
+    CHECK_EQ(ranges.count(), 0u);
+    CHECK_EQ(ranges.representationSize(), 1000u);
+
+    CHECK(RangeRequest::parse("bytes=1000-,2000-", 1000).status() == Status::UNSATISFIABLE);
+}
+
+void testIgnored() {
+    // Invalid headers are ignored as RFC 7233 requires: the full representation is sent
+    CHECK(RangeRequest::parse("", 1000).status() == Status::IGNORED);
+    CHECK(RangeRequest::parse("items=0-9", 1000).status() == Status::IGNORED);
+    CHECK(RangeRequest::parse("bytes=9-2", 1000).status() == Status::IGNORED);
+    CHECK(RangeRequest::parse("bytes=abc", 1000).status() == Status::IGNORED);
+    CHECK(RangeRequest::parse("bytes=0-9,x-y", 1000).status() == Status::IGNORED);
+    CHECK(RangeRequest::parse("bytes=-", 1000).status() == Status::IGNORED);
+    CHECK(RangeRequest::parse("bytes=", 1000).status() == Status::IGNORED);
+}
+
+void testIfRange() {
+    const std::string etag = "\"1a-3e8-5f\"";
+    const std::string date = "Sat, 17 Oct 2026 10:00:00 GMT";
+
+    CHECK(RangeRequest::ifRangeMatches(etag, etag, date));
+    CHECK(RangeRequest::ifRangeMatches(" " + etag + " ", etag, date));
+    CHECK(!RangeRequest::ifRangeMatches("\"other\"", etag, date));
+    // Weak tags never match for ranges
+    CHECK(!RangeRequest::ifRangeMatches("W/" + etag, etag, date));
+    CHECK(!RangeRequest::ifRangeMatches(etag, "", date));
+
+    // Dates must match Last-Modified exactly
+    CHECK(RangeRequest::ifRangeMatches(date, etag, date));
+    CHECK(!RangeRequest::ifRangeMatches("Sat, 17 Oct 2026 10:00:01 GMT", etag, date));
+    CHECK(!RangeRequest::ifRangeMatches(date, etag, ""));
+    CHECK(!RangeRequest::ifRangeMatches("", etag, date));
+}
+
+void testMultipartLayout() {
+    auto ranges = RangeRequest::parse("bytes=0-9,20-29", 100);
+    MultipartByteRanges layout(ranges, "video/mp4", "b");
+
+    // Walking the body segment by segment adds up to the announced length
+    char scratch[MultipartByteRanges::MAX_PART_HEADER];
+    std::string text;
+    uint64_t offset = 0;
+    uint64_t file_bytes = 0;
+    while (offset < layout.contentLength()) {
+        auto segment = layout.locate(offset, scratch);
+        CHECK(segment.length > 0);
+        if (segment.length == 0) {
+            break;
+        }
+        if (segment.text) {
+            text.append(segment.text, segment.length);
+        } else {
+            file_bytes += segment.length;
+        }
+        offset += segment.length;
+    }
+    CHECK_EQ(offset, layout.contentLength());
+    CHECK_EQ(file_bytes, 20u);
+    CHECK(text.find("Content-Range: bytes 0-9/100") != std::string::npos);
+    CHECK(text.find("Content-Range: bytes 20-29/100") != std::string::npos);
+    CHECK(text.find("\r\n--b--\r\n") != std::string::npos);
+}
+
+} // namespace
+
+int main() {
+    testSingleRanges();
+    testSuffixRanges();
+    testOpenEndedRanges();
+    testCoalescing();
+    testRangeCap();
+    testUnsatisfiable();
+    testIgnored();
+    testIfRange();
+    testMultipartLayout();
+    return test::result("range_request_test");
+}
@@ -0,0 +1,160 @@
+// tests/search_index_test.cpp
+#include "api/search_index.h"
+#include "test_support.h"
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+using namespace utec;
+
+namespace {
+
+using Index = FlatLibrary::Index;
+
+std::string lowered(std::string_view text) {
+    std::string result;
+    for (char c : text) {
+        result.push_back(c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c);
+    }
+    return result;
+}
+
+// Every video checked with a plain find, ordered as search() promises: by
+// rank, then name length, then the first appearance of the name, then
+// library order
+std::vector<Index> bruteForce(const FlatLibrary& library, std::string_view query) {
+    std::string needle = lowered(query);
+    std::unordered_map<std::string_view, Index> first_appearance;
+    std::vector<std::tuple<int, size_t, Index, Index>> matches;
+    for (Index v = 0; v < library.videoCount(); ++v) {
+        Index first = first_appearance.emplace(library.videoName(v), v).first->second;
+        std::string name = lowered(library.videoName(v));
+        size_t position = name.find(needle);
+        if (position == std::string::npos) {
+            continue;
+        }
+        int rank = 3;
+        if (position == 0) {
+            rank = name.size() == needle.size() ? 0 : 1;
+        } else {
+            for (; position != std::string::npos; position = name.find(needle, position + 1)) {
+                unsigned char before = static_cast<unsigned char>(name[position - 1]);
+                if (!std::isalnum(before) && before < 0x80) {
+                    rank = 2;
+                    break;
+                }
+            }
+        }
+        matches.emplace_back(rank, name.size(), first, v);
+    }
+    std::sort(matches.begin(), matches.end());
+
+    std::vector<Index> videos;
+    for (const auto& match : matches) {
+        videos.push_back(std::get<3>(match));
+    }
+    return videos;
+}
+
+void testRanking() {
+    FlatLibrary library("/srv/videos");
+    library.addYear("2024");
+    library.addSemester("Semester_1");
+    library.addCourse("Algorithms", 1);
+    library.addVideo("Intro.mp4", 1);         // 0: prefix
+    library.addVideo("intro", 1);             // 1: exact
+    library.addVideo("Lab_Intro.mp4", 1);     // 2: word start
+    library.addVideo("Lab Intro.mp4", 1);     // 3: word start
+    library.addCourse("Databases", 1);
+    library.addVideo("Introduction.mp4", 1);  // 4: prefix, longer
+    library.addVideo("Retrointro.mp4", 1);    // 5: substring
+    library.addVideo("intro", 1);             // 6: same name as 1
+    library.finish();
+
+    SearchIndex index(library);
+    auto result = index.search("INTRO", 20);
+    CHECK_EQ(result.total, 7u);
+    CHECK(result.videos == (std::vector<Index>{1, 6, 0, 4, 2, 3, 5}));
+
+    // The limit cuts the ranked list, the total still counts every match
+    result = index.search("intro", 3);
+    CHECK_EQ(result.total, 7u);
+    CHECK(result.videos == (std::vector<Index>{1, 6, 0}));
+
+    // Queries shorter than a trigram
+    result = index.search("L", 20);
+    CHECK_EQ(result.total, 2u);
+    CHECK(result.videos == bruteForce(library, "L"));
+    result = index.search("ab", 20);
+    CHECK(result.videos == (std::vector<Index>{2, 3}));
+
+    CHECK_EQ(index.search("lecture", 20).total, 0u);
+    CHECK_EQ(index.search("", 20).total, 0u);
+    CHECK_EQ(index.search(std::string("in\0tro", 6), 20).total, 0u);
+}
+
+// Random names from a small vocabulary, so queries hit many names at every
+// rank; each query is a slice of some name with its case shuffled
+void testAgainstBruteForce() {
+    const char* words[] = {"Lab", "lecture", "\xC3\x9C" "ber", "ab", "a", "Week_01",
+                           "Intro", "b", "x.y", "ABC", "abcabc", "ML"};
+    const size_t word_count = sizeof(words) / sizeof(words[0]);
+    std::mt19937 random(7);
+
+    FlatLibrary library("/srv/videos");
+    library.addYear("2024");
+    library.addSemester("Semester_1");
+    for (int c = 0; c < 30; ++c) {
+        library.addCourse("Course_" + std::to_string(c), 1);
+        for (int v = 0; v < 60; ++v) {
+            std::string name;
+            size_t parts = 1 + random() % 3;
+            for (size_t i = 0; i < parts; ++i) {
+                if (i > 0) {
+                    name += random() % 2 ? " " : "_";
+                }
+                name += words[random() % word_count];
+            }
+            if (random() % 3 == 0) {
+                name += ".mp4";
+            }
+            library.addVideo(name, 1);
+        }
+    }
+    library.finish();
+
+    SearchIndex index(library);
+    for (int i = 0; i < 2000; ++i) {
+        std::string_view name = library.videoName(static_cast<Index>(random() % library.videoCount()));
+        std::string query(name.substr(random() % name.size(), 1 + random() % 6));
+        if (random() % 4 == 0) {
+            query[0] = "AZq\xC3"[random() % 4];
+        }
+        for (char& c : query) {
+            if (c >= 'a' && c <= 'z' && random() % 2) {
+                c = static_cast<char>(c - 'a' + 'A');
+            }
+        }
+
+        std::vector<Index> expected = bruteForce(library, query);
+        auto result = index.search(query, 20);
+        CHECK_EQ(result.total, expected.size());
+        expected.resize(std::min<size_t>(expected.size(), 20));
+        if (result.videos != expected) {
+            CHECK(result.videos == expected);
+            break;
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    testRanking();
+    testAgainstBruteForce();
+    return test::result("search_index_test");
+}
@@ -0,0 +1,63 @@
+// tests/string_utils_test.cpp
+#include "utils/string_utils.h"
+#include "test_support.h"
+#include <string>
+
+using namespace utec;
+
+namespace {
+
+void testHttpDateFormats() {
+    // The three formats RFC 7231 asks recipients to accept, for one instant
+    long long seconds = 0;
+    CHECK(StringUtils::parseHttpDate("Sun, 06 Nov 1994 08:49:37 GMT", seconds));
+    CHECK_EQ(seconds, 784111777LL);
+    seconds = 0;
+    CHECK(StringUtils::parseHttpDate("Sunday, 06-Nov-94 08:49:37 GMT", seconds));
+    CHECK_EQ(seconds, 784111777LL);
+    seconds = 0;
+    CHECK(StringUtils::parseHttpDate("Sun Nov  6 08:49:37 1994", seconds));
+    CHECK_EQ(seconds, 784111777LL);
+
+    CHECK(StringUtils::parseHttpDate("Thu, 01 Jan 1970 00:00:00 GMT", seconds));
+    CHECK_EQ(seconds, 0LL);
+    CHECK(StringUtils::parseHttpDate("Wed, 29 Feb 2040 23:59:59 GMT", seconds));
+    CHECK_EQ(seconds, 2214172799LL);
+}
+
+void testInvalidHttpDates() {
+    long long seconds = 0;
+    CHECK(!StringUtils::parseHttpDate("", seconds));
+    CHECK(!StringUtils::parseHttpDate("yesterday", seconds));
+    CHECK(!StringUtils::parseHttpDate("Sun, 06 Foo 1994 08:49:37 GMT", seconds));
+    CHECK(!StringUtils::parseHttpDate("Sun, 06 Nov 1994 08:49:37 GMT; length=12", seconds));
+    CHECK(!StringUtils::parseHttpDate("Sun, 06 Nov 1994 25:49:37 GMT", seconds));
+    CHECK(!StringUtils::parseHttpDate("Sun, 06 Nov 1994 08:49:37", seconds));
+}
+
+void testHttpDateRoundTrip() {
+    for (long long time = 0; time < 4102444800LL; time += 86400LL * 37 + 3601) {
+        long long parsed = -1;
+        CHECK(StringUtils::parseHttpDate(StringUtils::formatHttpDate(time), parsed));
+        CHECK_EQ(parsed, time);
+    }
+}
+
+// Published FNV-1a test vectors: validators built on it must not change
+// between runs or builds
+void testFnv1a() {
+    CHECK_EQ(StringUtils::fnv1a(""), 0xcbf29ce484222325ULL);
+    CHECK_EQ(StringUtils::fnv1a("a"), 0xaf63dc4c8601ec8cULL);
+    CHECK_EQ(StringUtils::fnv1a("foobar"), 0x85944171f73967e8ULL);
+    CHECK(StringUtils::fnv1a(std::string("a\0b", 3)) != StringUtils::fnv1a("a"));
+}
+
+} // namespace
+
+int main() {
+    testHttpDateFormats();
+    testInvalidHttpDates();
+    testHttpDateRoundTrip();
+    testFnv1a();
+    return test::result("string_utils_test");
+}
@@ -0,0 +1,35 @@
+// tests/test_support.h
+#pragma once
+#include <iostream>
+
+// Minimal checks for the unit tests: a failed CHECK is reported with its
+// location and makes the test exit with a failure, without stopping it
+namespace utec {
+namespace test {
+
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+
+    inline void fail(const char* file, int line, const char* expression) {
+        std::cerr << file << ":" << line << ": check failed: " << expression << "\n";
+        ++failures();
+    }
+
+    inline int result(const char* name) {
+        if (failures() > 0) {
+            std::cerr << name << ": " << failures() << " checks failed\n";
+            return 1;
+        }
+        std::cout << name << ": all checks passed\n";
+        return 0;
+    }
+
+} // namespace test
+} // namespace utec
+
+#define CHECK(expression) \
+    ((expression) ? static_cast<void>(0) : ::utec::test::fail(__FILE__, __LINE__, #expression))
+
+#define CHECK_EQ(actual, expected) CHECK((actual) == (expected))
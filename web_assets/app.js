@@ -26,13 +26,26 @@ function extractWeekNumber(filename) {
 }
 
 // API Functions
+// Parsed API responses by endpoint, revalidated with their ETag
+const apiCache = new Map();
+
 async function fetchAPI(endpoint) {
     try {
-        const response = await fetch(`${window.SERVER_URL}/api/${endpoint}`);
+        const cached = apiCache.get(endpoint);
+        const headers = cached ? { 'If-None-Match': cached.etag } : {};
+        const response = await fetch(`${window.SERVER_URL}/api/${endpoint}`, { headers, cache: 'no-store' });
+        if (response.status === 304 && cached) {
+            return cached.data;
+        }
         if (!response.ok) {
             throw new Error(`HTTP ${response.status}: ${response.statusText}`);
         }
-        return await response.json();
+        const data = await response.json();
+        const etag = response.headers.get('ETag');
+        if (etag) {
+            apiCache.set(endpoint, { etag, data });
+        }
+        return data;
     } catch (error) {
         console.error('API Error:', error);
         throw error;
@@ -98,7 +111,13 @@ function showLibrary() {
 
 // Create semester card
 function createSemesterCard(year, semester) {
-    const totalVideos = semester.courses.reduce((sum, course) => sum + course.video_count, 0);
+    // Courses the server has not listed yet have a null video_count
+    const indexed = semester.courses.filter(course => course.video_count !== null);
+    const totalVideos = indexed.reduce((sum, course) => sum + course.video_count, 0);
+    const pending = semester.courses.length - indexed.length;
+    const videoSummary = pending === 0
+        ? `${totalVideos} videos`
+        : `${totalVideos}+ videos (${pending} not yet indexed)`;
 
     const card = document.createElement('div');
     card.className = 'card';
@@ -110,7 +129,7 @@ function createSemesterCard(year, semester) {
             ${semester.name} - ${year}
         </div>
         <div class="card-meta">
-            ${semester.courses.length} courses • ${totalVideos} videos
+            ${semester.courses.length} courses • ${videoSummary}
         </div>
         <div class="card-description">
             ${semester.courses.map(course => course.name).join(' • ')}
@@ -158,7 +177,7 @@ function createCourseCard(year, semesterName, course) {
             ${course.name}
         </div>
         <div class="card-meta">
-            ${course.video_count} videos available
+            ${course.video_count === null ? 'Not yet indexed' : `${course.video_count} videos available`}
         </div>
         <div class="card-description">
             Click to view all videos for this course
@@ -311,9 +330,9 @@ async function searchVideos() {
     const query = document.getElementById('search-input').value.trim();
     if (!query) return;
 
-    // Simple client-side search for now
     if (!currentLibrary) return;
 
+    // Courses are matched here; videos by the server's index
     const results = [];
     currentLibrary.years.forEach(year => {
         year.semesters.forEach(semester => {
@@ -330,6 +349,15 @@ async function searchVideos() {
         });
     });
 
+    try {
+        const response = await fetchAPI(`search?q=${encodeURIComponent(query)}`);
+        response.data.results.forEach(video => {
+            results.push({ type: 'video', video });
+        });
+    } catch (error) {
+        showToast('Video search failed, showing matching courses only');
+    }
+
     showSearchResults(query, results);
 }
 
@@ -361,6 +389,12 @@ function showSearchResults(query, results) {
         if (result.type === 'course') {
             const courseCard = createCourseCard(result.year, result.semester, result.course);
             container.appendChild(courseCard);
+        } else if (result.type === 'video') {
+            const videoCard = createVideoCard(result.video);
+            const course = document.createElement('span');
+            course.textContent = `${result.video.course} · ${result.video.semester} ${result.video.year}`;
+            videoCard.querySelector('.video-meta').appendChild(course);
+            container.appendChild(videoCard);
         }
     });
 }